@@ -0,0 +1,118 @@
+#include "anomaly_detector.h"
+#include <WiFi.h>
+#include "debug_system.h"
+#include "upload_pipeline.h"
+#include "status_store.h"
+
+static constexpr char TAG[] = "anomaly";
+
+float AnomalyDetector::mean = 0;
+float AnomalyDetector::variance = 0;
+float AnomalyDetector::rate = 0;
+float AnomalyDetector::lastValue = 0;
+unsigned long AnomalyDetector::lastTime = 0;
+uint32_t AnomalyDetector::sampleCount = 0;
+bool AnomalyDetector::active[ANOMALY_TYPE_COUNT] = {false, false, false};
+uint32_t AnomalyDetector::eventCount = 0;
+
+void AnomalyDetector::update(float value, unsigned long now) {
+    if (isnan(value)) {
+        return;
+    }
+
+    if (sampleCount == 0) {
+        mean = value;
+        variance = 0;
+        rate = 0;
+    } else {
+        // 변화율 (°C/분) - 샘플 간격이 달라도 시간 기준으로 환산 후 평활
+        float minutes = (now - lastTime) / 60000.0f;
+        if (minutes > 0) {
+            float instant = (value - lastValue) / minutes;
+            rate += TEMP_RATE_ALPHA * (instant - rate);
+        }
+    }
+
+    bool warmedUp = sampleCount >= TEMP_ALERT_WARMUP;
+
+    // 1. 절대 임계값 (히스테리시스로 경계 근처 떨림 방지)
+    if (!active[ANOMALY_HIGH_TEMP] && value >= TEMP_ALERT_HIGH) {
+        setState(ANOMALY_HIGH_TEMP, true, value);
+    } else if (active[ANOMALY_HIGH_TEMP] && value < TEMP_ALERT_HIGH - TEMP_ALERT_HYSTERESIS) {
+        setState(ANOMALY_HIGH_TEMP, false, value);
+    }
+
+    // 2. 급상승 - 임계값의 절반 아래로 내려가야 해제
+    if (warmedUp && !active[ANOMALY_RAPID_RISE] && rate >= TEMP_ALERT_RATE) {
+        setState(ANOMALY_RAPID_RISE, true, value);
+    } else if (active[ANOMALY_RAPID_RISE] && rate < TEMP_ALERT_RATE / 2) {
+        setState(ANOMALY_RAPID_RISE, false, value);
+    }
+
+    // 3. 평균 대비 이탈 - 이번 샘플을 반영하기 전의 평균/분산으로 판정
+    float sigma = max(sqrtf(variance), TEMP_ALERT_MIN_SIGMA);
+    float z = fabsf(value - mean) / sigma;
+    if (warmedUp && !active[ANOMALY_DEVIATION] && z >= TEMP_ALERT_SIGMA) {
+        setState(ANOMALY_DEVIATION, true, value);
+    } else if (active[ANOMALY_DEVIATION] && z < TEMP_ALERT_SIGMA / 2) {
+        setState(ANOMALY_DEVIATION, false, value);
+    }
+
+    // EWMA 평균/분산 갱신
+    float diff = value - mean;
+    float incr = TEMP_EWMA_ALPHA * diff;
+    mean += incr;
+    variance = (1 - TEMP_EWMA_ALPHA) * (variance + diff * incr);
+
+    lastValue = value;
+    lastTime = now;
+    sampleCount++;
+}
+
+void AnomalyDetector::setState(AnomalyType type, bool raised, float value) {
+    active[type] = raised;
+    LOG_I(TAG, "%s%s (%.1f°C, %.2f°C/min)", raised ? "🚨 Alert raised: " : "✅ Alert cleared: ",
+          typeName(type), value, rate);
+    sendEvent(type, raised, value);
+}
+
+void AnomalyDetector::sendEvent(AnomalyType type, bool raised, float value) {
+    JsonDocument doc;
+    doc["device_id"] = StatusStore::deviceId();
+    doc["type"] = typeName(type);
+    doc["state"] = raised ? "raised" : "cleared";
+    doc["temperature"] = value;
+    doc["rate"] = rate;
+    doc["mean"] = mean;
+    doc["sigma"] = sqrtf(variance);
+    doc["timestamp"] = millis() / 1000;
+    doc["rssi"] = WiFi.RSSI();
+
+    // 주기 전송을 기다리지 않고 업로드 큐 맨 앞에 넣음
+    UploadPipeline::enqueueDocument("/alert", doc, true);
+    eventCount++;
+}
+
+bool AnomalyDetector::isActive(AnomalyType type) {
+    return active[type];
+}
+
+const char* AnomalyDetector::typeName(AnomalyType type) {
+    static const char* names[ANOMALY_TYPE_COUNT] = {"high_temperature", "rapid_rise", "deviation"};
+    return names[type];
+}
+
+void AnomalyDetector::getState(JsonObject obj) {
+    obj["mean"] = mean;
+    obj["sigma"] = sqrtf(variance);
+    obj["rate"] = rate;
+    obj["samples"] = sampleCount;
+    obj["events"] = eventCount;
+
+    JsonArray alerts = obj["active"].to<JsonArray>();
+    for (int i = 0; i < ANOMALY_TYPE_COUNT; i++) {
+        if (active[i]) {
+            alerts.add(typeName((AnomalyType)i));
+        }
+    }
+}
@@ -0,0 +1,37 @@
+#ifndef ANOMALY_DETECTOR_H
+#define ANOMALY_DETECTOR_H
+
+#include <ArduinoJson.h>
+#include "config.h"
+
+enum AnomalyType {
+    ANOMALY_HIGH_TEMP,     // 절대 임계값 초과 (발열/열사병)
+    ANOMALY_RAPID_RISE,    // 분당 상승률 초과
+    ANOMALY_DEVIATION,     // EWMA 평균 대비 급격한 이탈
+    ANOMALY_TYPE_COUNT
+};
+
+// 온도 샘플마다 O(1) 메모리/연산으로 갱신되는 이상 감지기
+// 경보 상태가 바뀌는 순간 업로드 큐 맨 앞에 /alert 이벤트를 넣음
+class AnomalyDetector {
+private:
+    static float mean;
+    static float variance;
+    static float rate;              // 평활된 변화율 (°C/분)
+    static float lastValue;
+    static unsigned long lastTime;
+    static uint32_t sampleCount;
+    static bool active[ANOMALY_TYPE_COUNT];
+    static uint32_t eventCount;
+
+    static void setState(AnomalyType type, bool raised, float value);
+    static void sendEvent(AnomalyType type, bool raised, float value);
+
+public:
+    static void update(float value, unsigned long now);
+    static bool isActive(AnomalyType type);
+    static const char* typeName(AnomalyType type);
+    static void getState(JsonObject obj);
+};
+
+#endif // ANOMALY_DETECTOR_H
@@ -0,0 +1,305 @@
+#include "app_tasks.h"
+#include "debug_system.h"
+#include "sensor_manager.h"
+#include "camera_manager.h"
+#include "wifi_manager.h"
+#include "upload_pipeline.h"
+#include "telemetry_batcher.h"
+#include "web_jobs.h"
+#include "loop_profiler.h"
+#include "metrics.h"
+#include "status_store.h"
+#include "scheduler.h"
+
+static constexpr char TAG[] = "tasks";
+
+// 런타임 통계가 켜진 빌드면 모든 태스크의 CPU 사용률을 커널 카운터로 계산
+#if defined(configGENERATE_RUN_TIME_STATS) && configGENERATE_RUN_TIME_STATS && configUSE_TRACE_FACILITY
+#define APP_RUNTIME_STATS 1
+#else
+#define APP_RUNTIME_STATS 0
+#endif
+
+static const uint32_t TASK_BUCKETS_US[] = {100, 500, 1000, 5000, 10000, 50000, 100000, 500000};
+static const uint8_t TASK_BUCKET_COUNT = sizeof(TASK_BUCKETS_US) / sizeof(TASK_BUCKETS_US[0]);
+static MetricHistogram sensorCycle("peteye_task_cycle_us", "Work time per task cycle, excluding waits",
+                                   TASK_BUCKETS_US, TASK_BUCKET_COUNT, "task", "sensors");
+static MetricHistogram cameraCycle("peteye_task_cycle_us", "Work time per task cycle, excluding waits",
+                                   TASK_BUCKETS_US, TASK_BUCKET_COUNT, "task", "camera");
+static MetricHistogram netCycle("peteye_task_cycle_us", "Work time per task cycle, excluding waits",
+                                TASK_BUCKETS_US, TASK_BUCKET_COUNT, "task", "net");
+static MetricHistogram* const cycleHistograms[APP_TASK_COUNT] = {&sensorCycle, &cameraCycle, &netCycle};
+
+// 보고에 포함할 기존/시스템 태스크 (이름으로 조회, 없으면 건너뜀)
+static const char* const SYSTEM_TASKS[] = {
+    "loopTask", "async_tcp", "upload", "web_jobs", "events", "stream_cap", "arduino_events", "wifi", "tiT"
+};
+static const uint8_t SYSTEM_TASK_COUNT = sizeof(SYSTEM_TASKS) / sizeof(SYSTEM_TASKS[0]);
+
+AppTaskInfo AppTasks::tasks[APP_TASK_COUNT] = {
+    {"sensors", nullptr, 0, 0, 0},
+    {"camera", nullptr, 0, 0, 0},
+    {"net", nullptr, 0, 0, 0}
+};
+EventGroupHandle_t AppTasks::events = nullptr;
+portMUX_TYPE AppTasks::statsMux = portMUX_INITIALIZER_UNLOCKED;
+
+// 이벤트 그룹만 먼저 - WiFiManager::init()이 비트를 쓰기 전에 호출
+void AppTasks::init() {
+    if (events == nullptr) {
+        events = xEventGroupCreate();
+    }
+}
+
+void AppTasks::startAll() {
+    // 업로드를 만드는 작업은 묶어서 실행 (라디오가 한 번만 깨도록)
+    Scheduler::every("telemetry", TELEMETRY_SAMPLE_INTERVAL, TelemetryBatcher::addReading,
+                     TELEMETRY_SAMPLE_INTERVAL, true);
+    
+    start(APP_TASK_SENSORS, sensorLoop, SENSOR_TASK_STACK, SENSOR_TASK_PRIORITY, IO_CORE);
+    if (ENABLE_CAMERA && StatusStore::cameraInitialized()) {
+        Scheduler::every("snapshot", SNAPSHOT_INTERVAL, requestSnapshot, 0, true);
+        start(APP_TASK_CAMERA, cameraLoop, CAMERA_TASK_STACK, CAMERA_TASK_PRIORITY, IO_CORE);
+    }
+    start(APP_TASK_NET, netLoop, NET_TASK_STACK, NET_TASK_PRIORITY, NET_CORE);
+}
+
+void AppTasks::start(AppTaskId id, TaskFunction_t loop, uint32_t stack, UBaseType_t priority, BaseType_t core) {
+    AppTaskInfo& task = tasks[id];
+    if (task.handle != nullptr) {
+        return;
+    }
+    
+    task.startedUs = esp_timer_get_time();
+    if (xTaskCreatePinnedToCore(loop, task.name, stack, nullptr, priority, &task.handle, core) != pdPASS) {
+        task.handle = nullptr;
+        LOG_E(TAG, "❌ Failed to start %s task", task.name);
+        return;
+    }
+    LOG_I(TAG, "Task %s started (core %d, priority %u)", task.name, (int)core, (unsigned)priority);
+}
+
+void AppTasks::setBits(EventBits_t bits) {
+    if (events != nullptr) {
+        xEventGroupSetBits(events, bits);
+    }
+}
+
+void AppTasks::clearBits(EventBits_t bits) {
+    if (events != nullptr) {
+        xEventGroupClearBits(events, bits);
+    }
+}
+
+bool AppTasks::isWiFiUp() {
+    return events != nullptr && (xEventGroupGetBits(events) & APP_EVENT_WIFI_UP);
+}
+
+void AppTasks::recordCycle(AppTaskId id, int64_t startUs) {
+    int64_t elapsed = esp_timer_get_time() - startUs;
+    cycleHistograms[id]->observe((uint32_t)elapsed);
+    
+    portENTER_CRITICAL(&statsMux);
+    tasks[id].cycles++;
+    tasks[id].busyUs += elapsed;
+    portEXIT_CRITICAL(&statsMux);
+}
+
+// 센서 상태 기계, 센서를 쓰는 웹 작업, 예약 작업 - 고정 주기 (= 스케줄러 틱)
+void AppTasks::sensorLoop(void* param) {
+    TickType_t wake = xTaskGetTickCount();
+    for (;;) {
+        int64_t start = esp_timer_get_time();
+        {
+            ProfileScope cycle(PROFILE_LOOP);
+            
+            // 센서/카메라를 쓰는 웹 작업 처리 (요청 자체는 비동기 서버가 처리)
+            {
+                ProfileScope scope(PROFILE_JOBS);
+                WebJobs::runSensorJobs();
+            }
+            
+            {
+                ProfileScope scope(PROFILE_SENSOR);
+                SensorManager::update();
+            }
+            
+            // 만기된 예약 작업 (측정값 수집/배치 전송, 온도 읽기 시작, 스냅샷 신호)
+            {
+                ProfileScope scope(PROFILE_SCHEDULER);
+                Scheduler::tick();
+            }
+        }
+        recordCycle(APP_TASK_SENSORS, start);
+        vTaskDelayUntil(&wake, pdMS_TO_TICKS(SENSOR_TASK_PERIOD));
+    }
+}
+
+// APP_EVENT_CAPTURE 신호(스냅샷 작업, WiFi 연결 직후)마다 캡처
+void AppTasks::cameraLoop(void* param) {
+    unsigned long lastCapture = 0;
+    for (;;) {
+        xEventGroupWaitBits(events, APP_EVENT_CAPTURE, pdTRUE, pdFALSE, portMAX_DELAY);
+        
+        // 오프라인이면 OfflineQueue 보관 간격보다 자주 찍지 않음 (찍어도 보관되지 않음)
+        if (!isWiFiUp() && lastCapture != 0 && millis() - lastCapture < OFFLINE_FRAME_INTERVAL) {
+            continue;
+        }
+        
+        int64_t start = esp_timer_get_time();
+        {
+            ProfileScope scope(PROFILE_SNAPSHOT);
+            lastCapture = millis();
+            captureSnapshot();
+        }
+        recordCycle(APP_TASK_CAMERA, start);
+    }
+}
+
+// WiFi 연결/스캔 상태 기계 - 기다리지 않으므로 짧은 주기로 확인만
+void AppTasks::netLoop(void* param) {
+    for (;;) {
+        int64_t start = esp_timer_get_time();
+        {
+            ProfileScope scope(PROFILE_WIFI);
+            WiFiManager::update();
+        }
+        recordCycle(APP_TASK_NET, start);
+        vTaskDelay(pdMS_TO_TICKS(NET_TASK_PERIOD));
+    }
+}
+
+// 스냅샷 작업 - 캡처는 camera 태스크가 (sensors 태스크를 붙잡지 않음)
+void AppTasks::requestSnapshot() {
+    setBits(APP_EVENT_CAPTURE);
+}
+
+void AppTasks::captureSnapshot() {
+    if (!CameraManager::isInitialized()) {
+        LOG_I(TAG, "Camera not initialized - skipping snapshot");
+        return;
+    }
+    
+    // 카메라 프레임 캡처 (PSRAM 사본, 드라이버 버퍼는 즉시 반환)
+    SharedFrame* frame = CameraManager::captureShared();
+    if (!frame) {
+        LOG_E(TAG, "❌ Failed to capture frame");
+        return;
+    }
+    
+    LOG_D(TAG, "📸 Captured frame: %u bytes, %ux%u",
+          (unsigned)frame->len, (unsigned)frame->width, (unsigned)frame->height);
+    
+    // 업로드는 업로드 태스크가 처리 - 여기서는 큐에 넣고 바로 반환
+    UploadPipeline::enqueueFrame(frame);
+}
+
+// 앱 태스크 + 시스템 태스크의 코어/우선순위/최소 여유 스택/CPU 사용률
+uint8_t AppTasks::collect(TaskReportRow* rows, uint8_t maxRows) {
+    TaskHandle_t handles[APP_TASK_COUNT + SYSTEM_TASK_COUNT];
+    const char* names[APP_TASK_COUNT + SYSTEM_TASK_COUNT];
+    uint8_t count = 0;
+    
+    for (int i = 0; i < APP_TASK_COUNT; i++) {
+        if (tasks[i].handle != nullptr) {
+            handles[count] = tasks[i].handle;
+            names[count++] = tasks[i].name;
+        }
+    }
+    for (int i = 0; i < SYSTEM_TASK_COUNT; i++) {
+        TaskHandle_t handle = xTaskGetHandle(SYSTEM_TASKS[i]);
+        if (handle != nullptr) {
+            handles[count] = handle;
+            names[count++] = SYSTEM_TASKS[i];
+        }
+    }
+    count = min(count, maxRows);
+    
+#if APP_RUNTIME_STATS
+    UBaseType_t taskCount = uxTaskGetNumberOfTasks();
+    TaskStatus_t* status = (TaskStatus_t*)malloc(taskCount * sizeof(TaskStatus_t));
+    uint32_t totalRunTime = 0;
+    if (status != nullptr) {
+        taskCount = uxTaskGetSystemState(status, taskCount, &totalRunTime);
+    }
+#endif
+    
+    for (uint8_t i = 0; i < count; i++) {
+        TaskReportRow& row = rows[i];
+        row.name = names[i];
+        BaseType_t affinity = xTaskGetAffinity(handles[i]);
+        row.core = affinity == tskNO_AFFINITY ? -1 : (int)affinity;
+        row.priority = uxTaskPriorityGet(handles[i]);
+        row.stackFree = uxTaskGetStackHighWaterMark(handles[i]);
+        row.cpu = -1;
+        
+#if APP_RUNTIME_STATS
+        for (UBaseType_t k = 0; status != nullptr && totalRunTime > 0 && k < taskCount; k++) {
+            if (status[k].xHandle == handles[i]) {
+                row.cpu = status[k].ulRunTimeCounter * 100.0f / totalRunTime;
+                break;
+            }
+        }
+#else
+        // 커널 통계가 없으면 앱 태스크만 직접 잰 작업 시간으로
+        int64_t now = esp_timer_get_time();
+        for (int k = 0; k < APP_TASK_COUNT; k++) {
+            if (tasks[k].handle == handles[i] && now > tasks[k].startedUs) {
+                portENTER_CRITICAL(&statsMux);
+                uint64_t busy = tasks[k].busyUs;
+                portEXIT_CRITICAL(&statsMux);
+                row.cpu = busy * 100.0f / (now - tasks[k].startedUs);
+                break;
+            }
+        }
+#endif
+    }
+    
+#if APP_RUNTIME_STATS
+    free(status);
+#endif
+    return count;
+}
+
+void AppTasks::getStats(JsonObject obj) {
+    obj["runtimeStats"] = (bool)APP_RUNTIME_STATS;
+    
+    TaskReportRow rows[APP_TASK_COUNT + SYSTEM_TASK_COUNT];
+    uint8_t count = collect(rows, APP_TASK_COUNT + SYSTEM_TASK_COUNT);
+    
+    JsonArray list = obj["tasks"].to<JsonArray>();
+    for (uint8_t i = 0; i < count; i++) {
+        JsonObject task = list.add<JsonObject>();
+        task["name"] = rows[i].name;
+        task["core"] = rows[i].core;
+        task["priority"] = rows[i].priority;
+        task["stackFree"] = rows[i].stackFree;
+        if (rows[i].cpu >= 0) {
+            task["cpu"] = rows[i].cpu;
+        }
+    }
+    
+    JsonObject cycles = obj["cycles"].to<JsonObject>();
+    for (int i = 0; i < APP_TASK_COUNT; i++) {
+        cycles[tasks[i].name] = tasks[i].cycles;
+    }
+}
+
+void AppTasks::printReport(Print& out) {
+    TaskReportRow rows[APP_TASK_COUNT + SYSTEM_TASK_COUNT];
+    uint8_t count = collect(rows, APP_TASK_COUNT + SYSTEM_TASK_COUNT);
+    
+    out.printf("---- tasks (cpu %% of one core%s) ----\n", APP_RUNTIME_STATS ? "" : ", app tasks only");
+    out.printf("%-15s %4s %4s %10s %7s\n", "task", "core", "prio", "stack free", "cpu %");
+    for (uint8_t i = 0; i < count; i++) {
+        char core[4] = "-";
+        char cpu[8] = "-";
+        if (rows[i].core >= 0) {
+            snprintf(core, sizeof(core), "%d", rows[i].core);
+        }
+        if (rows[i].cpu >= 0) {
+            snprintf(cpu, sizeof(cpu), "%.1f", rows[i].cpu);
+        }
+        out.printf("%-15s %4s %4u %10u %7s\n", rows[i].name, core, rows[i].priority, rows[i].stackFree, cpu);
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef APP_TASKS_H
+#define APP_TASKS_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/event_groups.h"
+#include "config.h"
+
+// 태스크 사이 신호 (이벤트 그룹 비트)
+#define APP_EVENT_WIFI_UP   (1 << 0)  // 스테이션 연결됨 (WiFiManager가 관리)
+#define APP_EVENT_CAPTURE   (1 << 1)  // 스냅샷 찍기 (스냅샷 작업 주기마다, WiFi 연결 직후 바로)
+
+enum AppTaskId {
+    APP_TASK_SENSORS,   // 센서 상태 기계, 하드웨어 웹 작업, 스케줄러 틱 (코어 1)
+    APP_TASK_CAMERA,    // 스냅샷 캡처 → 업로드 큐 (코어 1)
+    APP_TASK_NET,       // WiFi 연결/스캔 상태 기계 (코어 0)
+    APP_TASK_COUNT
+};
+
+// 앱 태스크별 실행 기록 - 일한 시간만 합산해 CPU 사용률을 계산
+struct AppTaskInfo {
+    const char* name;
+    TaskHandle_t handle;
+    uint32_t cycles;
+    uint64_t busyUs;
+    int64_t startedUs;
+};
+
+// 보고용 한 줄 (앱 태스크 + 이름으로 찾은 시스템 태스크)
+struct TaskReportRow {
+    const char* name;
+    int core;               // -1 = 고정 안 됨
+    unsigned priority;
+    uint32_t stackFree;     // 부팅 후 최소 여유 스택 (bytes)
+    float cpu;              // 코어 하나 기준 %, 모르면 -1
+};
+
+// loop() 하나에 몰려 있던 일을 코어별 전용 태스크로 분리
+// 카메라/센서는 코어 1, 네트워크는 코어 0 (AsyncTCP, 업로드, 웹 작업과 같은 쪽)
+// 데이터는 기존 큐(업로드, 웹 작업)로, 상태 변화는 이벤트 그룹으로 전달
+class AppTasks {
+private:
+    static AppTaskInfo tasks[APP_TASK_COUNT];
+    static EventGroupHandle_t events;
+    static portMUX_TYPE statsMux;
+
+    static void sensorLoop(void* param);
+    static void cameraLoop(void* param);
+    static void netLoop(void* param);
+    static void start(AppTaskId id, TaskFunction_t loop, uint32_t stack, UBaseType_t priority, BaseType_t core);
+    static void recordCycle(AppTaskId id, int64_t startUs);
+    static void requestSnapshot();
+    static void captureSnapshot();
+    static uint8_t collect(TaskReportRow* rows, uint8_t maxRows);
+
+public:
+    static void init();
+    static void startAll();
+    static void setBits(EventBits_t bits);
+    static void clearBits(EventBits_t bits);
+    static bool isWiFiUp();
+    static void getStats(JsonObject obj);
+    static void printReport(Print& out);
+};
+
+#endif // APP_TASKS_H
@@ -0,0 +1,194 @@
+#include "backend_client.h"
+#include "debug_system.h"
+
+static constexpr char TAG[] = "backend";
+
+BackendConnection BackendClient::pool[BACKEND_POOL_SIZE];
+SemaphoreHandle_t BackendClient::poolMutex = nullptr;
+SemaphoreHandle_t BackendClient::freeSlots = nullptr;
+BackendStats BackendClient::stats = {};
+String BackendClient::host;
+uint16_t BackendClient::port = 80;
+String BackendClient::basePath;
+
+void BackendClient::init() {
+    if (poolMutex != nullptr) {
+        return;
+    }
+
+    // "http://host:port/path" 를 한 번만 파싱
+    String url = API_BASE_URL;
+    int schemeEnd = url.indexOf("://");
+    String rest = schemeEnd >= 0 ? url.substring(schemeEnd + 3) : url;
+    int pathStart = rest.indexOf('/');
+    String authority = pathStart >= 0 ? rest.substring(0, pathStart) : rest;
+    basePath = pathStart >= 0 ? rest.substring(pathStart) : String("");
+
+    int colon = authority.indexOf(':');
+    if (colon >= 0) {
+        host = authority.substring(0, colon);
+        port = authority.substring(colon + 1).toInt();
+    } else {
+        host = authority;
+    }
+
+    for (int i = 0; i < BACKEND_POOL_SIZE; i++) {
+        pool[i].inUse = false;
+        pool[i].lastUsed = 0;
+        pool[i].http.setReuse(true);
+    }
+
+    poolMutex = xSemaphoreCreateMutex();
+    freeSlots = xSemaphoreCreateCounting(BACKEND_POOL_SIZE, BACKEND_POOL_SIZE);
+    LOG_I(TAG, "Backend client: %s:%u%s (pool %d)", host.c_str(), port, basePath.c_str(), BACKEND_POOL_SIZE);
+}
+
+BackendConnection* BackendClient::acquire() {
+    if (xSemaphoreTake(freeSlots, pdMS_TO_TICKS(BACKEND_ACQUIRE_TIMEOUT)) != pdTRUE) {
+        return nullptr;
+    }
+
+    xSemaphoreTake(poolMutex, portMAX_DELAY);
+
+    // 이미 연결된 슬롯을 우선 사용
+    BackendConnection* conn = nullptr;
+    for (int i = 0; i < BACKEND_POOL_SIZE; i++) {
+        if (!pool[i].inUse && (conn == nullptr || pool[i].client.connected())) {
+            conn = &pool[i];
+        }
+    }
+    conn->inUse = true;
+
+    // 서버가 먼저 닫았을 가능성이 큰 오래된 유휴 연결은 미리 정리
+    if (conn->client.connected() && millis() - conn->lastUsed > BACKEND_IDLE_TIMEOUT) {
+        conn->client.stop();
+        stats.idleCloses++;
+    }
+
+    xSemaphoreGive(poolMutex);
+    return conn;
+}
+
+void BackendClient::release(BackendConnection* conn, const BackendStats& delta) {
+    xSemaphoreTake(poolMutex, portMAX_DELAY);
+    conn->inUse = false;
+    conn->lastUsed = millis();
+    stats.requests += delta.requests;
+    stats.connects += delta.connects;
+    stats.retries += delta.retries;
+    stats.failures += delta.failures;
+    stats.bodyCloses += delta.bodyCloses;
+    stats.lastLatencyMs = delta.lastLatencyMs;
+    xSemaphoreGive(poolMutex);
+    xSemaphoreGive(freeSlots);
+}
+
+// 응답 본문을 끝까지 읽어야 연결을 재사용할 수 있음 - 남은 바이트가 다음 응답의 시작으로 읽히므로
+// 길이를 모르거나(chunked/close) 너무 크거나 다 못 읽은 본문은 연결을 닫음
+void BackendClient::consumeBody(BackendConnection* conn, String* response, BackendStats& delta) {
+    int size = conn->http.getSize();
+    if (size == 0) {
+        return;
+    }
+    if (response == nullptr && (size < 0 || size > BACKEND_DRAIN_MAX)) {
+        conn->client.stop();
+        delta.bodyCloses++;
+        return;
+    }
+
+    String body = conn->http.getString();
+    if (size > 0 && body.length() != (unsigned)size) {
+        conn->client.stop();
+        delta.bodyCloses++;
+    }
+    if (response != nullptr) {
+        *response = body;
+    }
+}
+
+bool BackendClient::isStaleConnectionError(int code) {
+    return code == HTTPC_ERROR_SEND_HEADER_FAILED ||
+           code == HTTPC_ERROR_SEND_PAYLOAD_FAILED ||
+           code == HTTPC_ERROR_NOT_CONNECTED ||
+           code == HTTPC_ERROR_CONNECTION_LOST;
+}
+
+int BackendClient::post(const char* path, const char* contentType, const uint8_t* body, size_t len,
+                        uint16_t timeout, const BackendHeader* headers, uint8_t headerCount,
+                        String* response) {
+    if (poolMutex == nullptr) {
+        return HTTPC_ERROR_NOT_CONNECTED;
+    }
+
+    BackendConnection* conn = acquire();
+    if (conn == nullptr) {
+        LOG_E(TAG, "❌ Backend pool busy - request to %s skipped", path);
+        return HTTPC_ERROR_NOT_CONNECTED;
+    }
+
+    BackendStats delta = {};
+    delta.requests = 1;
+    unsigned long start = millis();
+    int httpCode = 0;
+
+    for (int attempt = 0; attempt < 2; attempt++) {
+        bool reused = conn->client.connected();
+        if (!reused) {
+            delta.connects++;
+        }
+
+        conn->http.begin(conn->client, host, port, basePath + path);
+        conn->http.setReuse(true);
+        conn->http.setTimeout(timeout);
+        conn->http.setConnectTimeout(API_TIMEOUT);
+        conn->http.addHeader("Content-Type", contentType);
+        for (uint8_t i = 0; i < headerCount; i++) {
+            conn->http.addHeader(headers[i].name, headers[i].value);
+        }
+
+        httpCode = conn->http.POST((uint8_t*)body, len);
+        if (httpCode > 0) {
+            consumeBody(conn, response, delta);
+        }
+        conn->http.end();  // keep-alive면 TCP 연결은 유지됨
+
+        // 재사용한 연결이 이미 끊겨 있었다면 새 연결로 한 번 더
+        if (reused && isStaleConnectionError(httpCode)) {
+            conn->client.stop();
+            delta.retries++;
+            continue;
+        }
+        break;
+    }
+
+    if (httpCode <= 0) {
+        conn->client.stop();
+        delta.failures++;
+    }
+
+    delta.lastLatencyMs = millis() - start;
+    release(conn, delta);
+    return httpCode;
+}
+
+void BackendClient::getStats(JsonObject obj) {
+    obj["host"] = host;
+    obj["port"] = port;
+    obj["poolSize"] = BACKEND_POOL_SIZE;
+
+    int open = 0;
+    for (int i = 0; i < BACKEND_POOL_SIZE; i++) {
+        if (pool[i].client.connected()) {
+            open++;
+        }
+    }
+    obj["openConnections"] = open;
+    obj["requests"] = stats.requests;
+    obj["connects"] = stats.connects;
+    obj["requestsPerConnect"] = stats.connects ? (float)stats.requests / stats.connects : 0;
+    obj["retries"] = stats.retries;
+    obj["idleCloses"] = stats.idleCloses;
+    obj["bodyCloses"] = stats.bodyCloses;
+    obj["failures"] = stats.failures;
+    obj["lastLatencyMs"] = stats.lastLatencyMs;
+}
@@ -0,0 +1,59 @@
+#ifndef BACKEND_CLIENT_H
+#define BACKEND_CLIENT_H
+
+#include <WiFi.h>
+#include <HTTPClient.h>
+#include <ArduinoJson.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "config.h"
+
+struct BackendHeader {
+    const char* name;
+    String value;
+};
+
+// 풀의 연결 하나 - WiFiClient를 HTTPClient 밖에 두어 요청 사이에 TCP 연결을 유지
+struct BackendConnection {
+    WiFiClient client;
+    HTTPClient http;
+    bool inUse;
+    unsigned long lastUsed;
+};
+
+struct BackendStats {
+    uint32_t requests;        // 논리 요청 수
+    uint32_t connects;        // 새 TCP 연결 수
+    uint32_t retries;         // 끊긴 keep-alive 연결로 인한 재시도
+    uint32_t idleCloses;      // 유휴 시간 초과로 닫은 연결
+    uint32_t bodyCloses;      // 응답 본문을 끝까지 읽지 못해 닫은 연결
+    uint32_t failures;
+    uint32_t lastLatencyMs;
+};
+
+// API_BASE_URL 호스트로 가는 모든 요청이 공유하는 keep-alive 연결 풀
+// 유휴 연결은 BACKEND_IDLE_TIMEOUT 후 닫고, 재사용한 연결이 끊겨 있으면 새로 연결해 한 번 재시도
+class BackendClient {
+private:
+    static BackendConnection pool[BACKEND_POOL_SIZE];
+    static SemaphoreHandle_t poolMutex;
+    static SemaphoreHandle_t freeSlots;
+    static BackendStats stats;
+    static String host;
+    static uint16_t port;
+    static String basePath;
+
+    static BackendConnection* acquire();
+    static void release(BackendConnection* conn, const BackendStats& delta);
+    static bool isStaleConnectionError(int code);
+    static void consumeBody(BackendConnection* conn, String* response, BackendStats& delta);
+
+public:
+    static void init();
+    static int post(const char* path, const char* contentType, const uint8_t* body, size_t len,
+                    uint16_t timeout, const BackendHeader* headers = nullptr, uint8_t headerCount = 0,
+                    String* response = nullptr);
+    static void getStats(JsonObject obj);
+};
+
+#endif // BACKEND_CLIENT_H
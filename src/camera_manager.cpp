@@ -1,22 +1,33 @@
 #include "camera_manager.h"
 #include <Wire.h>
 #include "driver/gpio.h"
+#include "metrics.h"
+#include "status_store.h"
 
 #define XPOWERS_CHIP_AXP2101
 #include "XPowersLib.h"
 
+static constexpr char TAG[] = "camera";
+
+static const uint32_t CAPTURE_BUCKETS_US[] = {5000, 10000, 20000, 40000, 70000, 100000, 200000, 500000};
+static const uint32_t FRAME_BUCKETS_BYTES[] = {10000, 20000, 40000, 60000, 80000, 120000, 160000, 240000};
+static MetricHistogram captureDuration("peteye_capture_duration_us", "Frame capture and PSRAM copy time",
+                                       CAPTURE_BUCKETS_US, sizeof(CAPTURE_BUCKETS_US) / sizeof(CAPTURE_BUCKETS_US[0]));
+static MetricHistogram frameSize("peteye_frame_bytes", "Captured JPEG frame size",
+                                 FRAME_BUCKETS_BYTES, sizeof(FRAME_BUCKETS_BYTES) / sizeof(FRAME_BUCKETS_BYTES[0]));
+
 XPowersPMU PMU;
 
 // PMU 초기화
 bool initCameraPMU() {
-    DebugSystem::log("Initializing AXP2101 PMU for Camera");
+    LOG_I(TAG, "Initializing AXP2101 PMU for Camera");
     
     if (!PMU.begin(Wire, AXP2101_SLAVE_ADDRESS, PMU_SDA, PMU_SCL)) {
-        DebugSystem::log("Failed to initialize PMU");
+        LOG_E(TAG, "Failed to initialize PMU");
         return false;
     }
     
-    DebugSystem::log("PMU initialized successfully");
+    LOG_I(TAG, "PMU initialized successfully");
     
     // 카메라 전원 설정 (공식 예제와 동일)
     PMU.setALDO1Voltage(1800);  // CAM DVDD 1.8V
@@ -31,7 +42,7 @@ bool initCameraPMU() {
     // TS Pin 비활성화 (충전 기능 사용시 필요)
     PMU.disableTSPinMeasure();
     
-    DebugSystem::log("Camera power rails configured");
+    LOG_I(TAG, "Camera power rails configured");
     delay(500);  // 전원 안정화
     
     return true;
@@ -39,11 +50,11 @@ bool initCameraPMU() {
 
 bool CameraManager::init() {
     if (!ENABLE_CAMERA) {
-        DebugSystem::log("Camera disabled in config");
+        LOG_I(TAG, "Camera disabled in config");
         return false;
     }
     
-    DebugSystem::log("========== Camera Initialization ==========");
+    LOG_D(TAG, "========== Camera Initialization ==========");
     
     // Step 1: GPIO13 설정 (JTAG 해제)
     gpio_config_t conf = {};
@@ -53,11 +64,11 @@ bool CameraManager::init() {
     conf.intr_type = GPIO_INTR_DISABLE;
     conf.pin_bit_mask = 1LL << 13;
     gpio_config(&conf);
-    DebugSystem::log("GPIO13 configured");
+    LOG_D(TAG, "GPIO13 configured");
     
     // Step 2: PMU 초기화
     if (!initCameraPMU()) {
-        DebugSystem::log("PMU initialization failed");
+        LOG_E(TAG, "PMU initialization failed");
         return false;
     }
     
@@ -104,15 +115,15 @@ bool CameraManager::init() {
     }
     
     // Step 4: 카메라 초기화
-    DebugSystem::log("Initializing camera driver...");
+    LOG_I(TAG, "Initializing camera driver...");
     esp_err_t err = esp_camera_init(&config);
     
     if (err != ESP_OK) {
-        DebugSystem::log("Camera init failed with error 0x" + String(err, HEX));
+        LOG_E(TAG, "Camera init failed with error 0x%x", err);
         return false;
     }
     
-    DebugSystem::log("Camera driver initialized");
+    LOG_I(TAG, "Camera driver initialized");
     
     // Step 5: 센서 설정
     sensor_t * s = esp_camera_sensor_get();
@@ -133,20 +144,20 @@ bool CameraManager::init() {
     delay(500);
     camera_fb_t* fb = esp_camera_fb_get();
     if (fb) {
-        DebugSystem::log("Test capture successful");
+        LOG_I(TAG, "Test capture successful");
         esp_camera_fb_return(fb);
-        sysStatus.cameraInitialized = true;
+        StatusStore::setCameraInitialized(true);
     } else {
-        DebugSystem::log("Test capture failed");
-        sysStatus.cameraInitialized = false;
+        LOG_E(TAG, "Test capture failed");
+        StatusStore::setCameraInitialized(false);
     }
     
-    DebugSystem::log("========== Camera Init Complete ==========");
-    return sysStatus.cameraInitialized;
+    LOG_D(TAG, "========== Camera Init Complete ==========");
+    return StatusStore::cameraInitialized();
 }
 
 camera_fb_t* CameraManager::capture() {
-    if (!sysStatus.cameraInitialized) {
+    if (!StatusStore::cameraInitialized()) {
         return nullptr;
     }
     return esp_camera_fb_get();
@@ -158,18 +169,61 @@ void CameraManager::releaseFrame(camera_fb_t* fb) {
     }
 }
 
+// 프레임을 PSRAM으로 복사하고 카메라 버퍼는 즉시 반환
+// 드라이버 버퍼(fb_count=2)를 오래 붙잡지 않아야 다음 캡처가 막히지 않음
+SharedFrame* CameraManager::captureShared() {
+    int64_t start = esp_timer_get_time();
+    camera_fb_t* fb = capture();
+    if (!fb) {
+        return nullptr;
+    }
+    
+    SharedFrame* frame = new SharedFrame();
+    frame->buf = (uint8_t*)(psramFound() ? ps_malloc(fb->len) : malloc(fb->len));
+    if (!frame->buf) {
+        delete frame;
+        releaseFrame(fb);
+        return nullptr;
+    }
+    
+    memcpy(frame->buf, fb->buf, fb->len);
+    frame->len = fb->len;
+    frame->width = fb->width;
+    frame->height = fb->height;
+    frame->timestamp = millis();
+    frame->refs.store(1);
+    releaseFrame(fb);
+    
+    captureDuration.observeSince(start);
+    frameSize.observe(frame->len);
+    return frame;
+}
+
+void CameraManager::retainShared(SharedFrame* frame) {
+    if (frame != nullptr) {
+        frame->refs.fetch_add(1);
+    }
+}
+
+void CameraManager::releaseShared(SharedFrame* frame) {
+    if (frame != nullptr && frame->refs.fetch_sub(1) == 1) {
+        free(frame->buf);
+        delete frame;
+    }
+}
+
 bool CameraManager::isInitialized() {
-    return sysStatus.cameraInitialized;
+    return StatusStore::cameraInitialized();
 }
 
 bool CameraManager::testCapture() {
-    if (!sysStatus.cameraInitialized) {
+    if (!StatusStore::cameraInitialized()) {
         return false;
     }
     
     camera_fb_t *fb = capture();
     if (fb) {
-        DebugSystem::log("Capture test OK");
+        LOG_I(TAG, "Capture test OK");
         releaseFrame(fb);
         return true;
     }
@@ -1,15 +1,30 @@
 #ifndef CAMERA_MANAGER_H
 #define CAMERA_MANAGER_H
 
+#include <atomic>
 #include "esp_camera.h"
 #include "config.h"
 #include "debug_system.h"
 
+// 여러 소비자(스트림 클라이언트 등)가 함께 쓰는 JPEG 프레임 사본
+// 마지막 참조가 해제될 때 버퍼가 반환됨
+struct SharedFrame {
+    uint8_t* buf;
+    size_t len;
+    uint16_t width;
+    uint16_t height;
+    unsigned long timestamp;
+    std::atomic<int> refs;
+};
+
 class CameraManager {
 public:
     static bool init();
     static camera_fb_t* capture();
     static void releaseFrame(camera_fb_t* fb);
+    static SharedFrame* captureShared();
+    static void retainShared(SharedFrame* frame);
+    static void releaseShared(SharedFrame* frame);
     static bool isInitialized();
     static bool testCapture();
 };
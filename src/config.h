@@ -65,33 +65,145 @@
 #define DEVICE_NAME "PetEye"
 #define WEB_SERVER_PORT 80
 #define STREAM_SERVER_PORT 81
+#define WIFI_CONNECT_TIMEOUT 15000   // 한 번의 연결 시도에서 IP를 기다리는 최대 시간 (ms)
+#define WIFI_BACKOFF_MIN 1000        // 첫 재시도 대기 (ms, 실패마다 두 배)
+#define WIFI_BACKOFF_MAX 60000       // 재시도 대기 상한 (ms)
+#define WIFI_BACKOFF_JITTER 25       // 재시도 대기에 더하는 무작위 편차 (±%)
+#define WIFI_AP_FALLBACK_FAILURES 5  // 부팅 후 연결된 적 없이 연속 실패하면 설정용 AP를 함께 켬
+#define WIFI_FAST_JOIN_TIMEOUT 4000  // 저장된 BSSID/채널로 바로 접속할 때 IP 대기 (실패하면 곧바로 전체 스캔)
+#define WIFI_SCAN_MAX_RESULTS 20     // 캐시에 보관할 네트워크 수 (SSID 중복 제거 후)
+#define WIFI_SCAN_MAX_AGE 30000      // 이보다 오래된 스캔 결과는 /scan 조회 때 백그라운드로 갱신 (ms)
+#define WIFI_FAST_REUSE_IP false     // true면 빠른 접속 때 마지막 IP를 고정 IP로 재사용 (DHCP 생략, 공유기에 주소 예약이 있을 때만)
+
+// ==================== TASK CONFIGURATION ====================
+// 코어 0: WiFi/AsyncTCP/업로드/웹 작업, 코어 1: 카메라/센서/IMU
+#define NET_CORE 0
+#define IO_CORE 1
+#define SENSOR_TASK_PRIORITY 3       // 측정 주기가 밀리지 않도록 가장 높게
+#define SENSOR_TASK_STACK 8192       // 하드웨어 웹 작업과 텔레메트리 문서 인코딩 포함
+#define SENSOR_TASK_PERIOD 10        // 센서 상태 기계 갱신 주기 (ms)
+#define CAMERA_TASK_PRIORITY 2
+#define CAMERA_TASK_STACK 4096
+#define NET_TASK_PRIORITY 2
+#define NET_TASK_STACK 4096
+#define NET_TASK_PERIOD 20           // WiFi 상태 기계 갱신 주기 (ms)
+#define SNAPSHOT_INTERVAL 5000       // 온라인일 때 스냅샷 업로드 주기 (ms)
+
+// ==================== SCHEDULER CONFIGURATION ====================
+// 주기 작업 간격은 /api/scheduler 로 바꿀 수 있음 (NVS에 저장, 아래 값은 기본값)
+#define SCHED_TICK_MS SENSOR_TASK_PERIOD   // 타이머 휠 한 칸 = sensors 태스크 주기
+#define SCHED_WHEEL_SLOTS 64               // 휠 칸 수 (한 바퀴 640ms, 더 긴 주기는 여러 바퀴)
+#define SCHED_MAX_JOBS 12
+#define SCHED_COALESCE_MS 1000             // 라디오 작업 실행 시 이 안에 예정된 라디오 작업도 함께 실행 (ms)
+
+// ==================== STREAM CONFIGURATION ====================
+#define STREAM_MAX_CLIENTS 4         // 동시 시청자 수
+#define STREAM_FRAME_INTERVAL 66     // 캡처 주기 (ms, 약 15fps)
+#define STREAM_CLIENT_QUEUE_LEN 2    // 클라이언트별 전송 대기 프레임 수
+#define STREAM_STATS_WINDOW 2000     // fps 계산 구간 (ms)
+
+// ==================== EVENTS CONFIGURATION ====================
+#define EVENTS_MAX_CLIENTS 4         // 동시 접속 콘솔 수
+#define EVENTS_POLL_INTERVAL 100     // 새 로그 확인 주기 (ms)
+#define EVENTS_STATUS_INTERVAL 1000  // 상태 변경 확인 주기 (ms)
+#define EVENTS_KEEPALIVE 15000       // 변경이 없을 때 연결 유지용 ping 전송 주기 (ms)
+#define EVENTS_REPLAY_LINES 100      // 새 콘솔에 한 번에 보내는 최근 로그 줄 수 (페이지 보관 줄 수와 같게)
+
+// ==================== WEB JOB CONFIGURATION ====================
+#define WEB_JOB_SLOTS 8              // 결과를 보관하는 작업 수 (오래된 완료 작업부터 재사용)
+#define WEB_JOB_STACK 8192           // 작업 태스크 스택 (HTTP 테스트, 스캔 등)
 
 // ==================== API CONFIGURATION ====================
 #define API_BASE_URL "http://192.168.0.10:5000/api"  // Python 서버 IP 주소
 #define API_TIMEOUT 5000
+#define BACKEND_POOL_SIZE 2          // 백엔드 keep-alive 연결 수 (업로드 태스크 + 웹 핸들러)
+#define BACKEND_IDLE_TIMEOUT 30000   // 이보다 오래 쉰 연결은 닫고 새로 연결 (ms)
+#define BACKEND_ACQUIRE_TIMEOUT 2000 // 풀에서 연결을 기다리는 최대 시간 (ms)
+#define BACKEND_DRAIN_MAX 2048       // 호출자가 안 읽는 응답 본문을 읽어 버리고 연결을 재사용할 최대 크기 (bytes)
+#define UPLOAD_TIMEOUT 15000     // 이미지 업로드 타임아웃 (이미지는 크므로)
+#define UPLOAD_QUEUE_LEN 3       // 업로드 대기 프레임 수 (가득 차면 오래된 것부터 버림)
+#define UPLOAD_WIRE_MSGPACK false  // true면 문서 업로드를 MessagePack으로 (백엔드가 415면 JSON으로 자동 전환)
+#define WIRE_BENCH_ITERATIONS 50   // /api/test/wire 인코딩 반복 횟수
+
+// ==================== OFFLINE QUEUE CONFIGURATION ====================
+#define OFFLINE_DIR "/offline"             // LittleFS 세그먼트 디렉터리
+#define OFFLINE_SEGMENT_SIZE 65536         // 세그먼트 파일 하나의 최대 크기 (bytes)
+#define OFFLINE_MAX_SEGMENTS 12            // 최대 세그먼트 수 (넘치면 가장 오래된 세그먼트 삭제)
+#define OFFLINE_MEMORY_RECORDS 16          // PSRAM 계층에 보관할 최대 레코드 수
+#define OFFLINE_MEMORY_BYTES 262144        // PSRAM 계층 최대 크기 (bytes)
+#define OFFLINE_PERSIST_DELAY 60000        // PSRAM에 이보다 오래 머문 레코드는 플래시로 이동 (ms)
+#define OFFLINE_INDEX_EVERY 8              // 재전송 레코드 N개마다 인덱스 저장 (플래시 쓰기 감소)
+#define OFFLINE_REPLAY_INTERVAL 500        // 업로드 큐가 이만큼 비어 있을 때 레코드 하나 재전송 (ms)
+#define OFFLINE_RETRY_BACKOFF 30000        // 재전송 실패 후 대기 (ms)
+#define OFFLINE_FRAME_INTERVAL 60000       // 오프라인 중 보관할 스냅샷 최소 간격 (ms)
+
+// ==================== METRICS CONFIGURATION ====================
+#define METRICS_MAX_BUCKETS 10             // 히스토그램 최대 버킷 수 (+Inf 제외)
+
+// ==================== PROFILER CONFIGURATION ====================
+#define PROFILE_WINDOW 128                 // 단계별로 보관할 최근 실행 시간 수 (p99/지터 계산 창)
 
 // ==================== DEBUG CONFIGURATION ====================
-#define DEBUG_BUFFER_SIZE 20
+// 1이면 바이너리 로그 - 포맷 ID, 타임스탬프, 원시 인자만 기록하고 해석은 호스트에서
+// (tools/log_decode.py + 빌드 시 생성되는 log_strings.json)
+#ifndef LOG_BINARY
+#define LOG_BINARY 0
+#endif
+
+#if LOG_BINARY
+#define DEBUG_BUFFER_SIZE 512    // 보관할 최대 레코드 수 (레코드가 짧으므로 더 많이)
+#else
+#define DEBUG_BUFFER_SIZE 64     // 보관할 최대 로그 줄 수
+#endif
+#define DEBUG_RING_BYTES 8192    // 로그 바이트 링 크기 (2의 거듭제곱)
+#define DEBUG_LINE_MAX 160       // 한 줄(레코드) 최대 길이 (타임스탬프 포함, 넘으면 잘림)
+#define LOG_BINARY_STR_MAX 32    // 바이너리 레코드에 넣는 문자열 인자 최대 길이
+
+// 로그 레벨 - 숫자가 클수록 자세함
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+#define LOG_LEVEL_TRACE 5
+
+// 이 레벨보다 자세한 로그 문장은 인자까지 컴파일에서 빠짐
+// 벤치 유닛은 build_flags에 -DLOG_LEVEL=LOG_LEVEL_DEBUG 지정 (실행 중 레벨은 /api/log/level)
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
 #define SERIAL_BAUD_RATE 115200
 
 // ==================== SENSOR CONFIGURATION ====================
 #define TEMP_READ_INTERVAL 5000  // 5초마다 온도 읽기
-#define API_SEND_INTERVAL 10000  // 10초마다 API 전송 (테스트용)
-
-// ==================== SYSTEM STATUS STRUCTURE ====================
-struct SystemStatus {
-    bool wifiConnected;
-    bool cameraInitialized;
-    bool tempSensorFound;
-    bool mpuConnected;
-    float currentTemp;
-    unsigned long lastTempRead;
-    unsigned long lastApiUpdate;
-    String deviceId;
-    IPAddress localIP;
-};
-
-// Global system status
-extern SystemStatus sysStatus;
+#define TEMP_RESOLUTION 12       // DS18B20 해상도 (12비트 = 750ms 변환)
+#define TEMP_MAX_RETRIES 1       // 85°C / -127°C 수신 시 재시도 횟수
+#define TEMP_RETRY_DELAY 100     // 재시도 전 대기 (ms)
+#define TEMP_RETRY_LONG_WAIT 1000  // -127°C 재시도 시 변환 대기 (ms)
+#define TEMP_BUS_WAIT 3000       // 진단 작업이 진행 중인 읽기 주기(변환 + 재시도)를 기다리는 최대 시간 (ms)
+#define MAX_TEMP_PROBES 8        // TEMP_SENSOR_PIN 버스의 최대 DS18B20 수 (최대 8)
+#define TEMP_PROBE_RING_SIZE 16  // 프로브별 최근 샘플 수
+
+// ==================== TELEMETRY CONFIGURATION ====================
+#define TELEMETRY_SAMPLE_INTERVAL 10000   // 10초마다 측정값 수집
+#define TELEMETRY_BATCH_SIZE 30           // 30개가 모이면 한 번에 전송
+#define TELEMETRY_BATCH_MAX_AGE 300000    // 가장 오래된 측정값이 5분 지나면 전송 (경보는 즉시 전송)
+
+// ==================== ALERT CONFIGURATION ====================
+#define TEMP_ALERT_HIGH 39.5f        // 고온 경보 (°C)
+#define TEMP_ALERT_HYSTERESIS 0.5f   // 고온 경보 해제 히스테리시스 (°C)
+#define TEMP_ALERT_RATE 0.5f         // 급상승 경보 (°C/분)
+#define TEMP_ALERT_SIGMA 4.0f        // 평균 대비 이탈 경보 (표준편차 배수)
+#define TEMP_ALERT_MIN_SIGMA 0.2f    // 표준편차 하한 (안정 상태에서 과민 반응 방지)
+#define TEMP_ALERT_WARMUP 12         // 변화율/이탈 판정 전 최소 샘플 수
+#define TEMP_EWMA_ALPHA 0.05f        // 평균/분산 EWMA 계수
+#define TEMP_RATE_ALPHA 0.3f         // 변화율 평활 계수
+
+// ==================== HISTORY CONFIGURATION ====================
+#define HISTORY_RAW_SAMPLES 8192   // 원본 샘플 (5초 간격 약 11시간)
+#define HISTORY_1M_BUCKETS 4320    // 1분 롤업 3일
+#define HISTORY_15M_BUCKETS 2016   // 15분 롤업 21일
+#define HISTORY_1H_BUCKETS 2160    // 1시간 롤업 90일
+#define HISTORY_CHUNK_POINTS 32    // /api/history 전송 시 한 번에 읽는 점 수
 
 #endif // CONFIG_H
\ No newline at end of file
@@ -1,40 +1,256 @@
 #include "debug_system.h"
+#include <stdarg.h>
 
-String DebugSystem::debugMessages[DEBUG_BUFFER_SIZE];
-int DebugSystem::debugIndex = 0;
+static_assert((DEBUG_RING_BYTES & (DEBUG_RING_BYTES - 1)) == 0, "DEBUG_RING_BYTES must be a power of two");
+static_assert(DEBUG_LINE_MAX < DEBUG_RING_BYTES, "DEBUG_LINE_MAX must fit in the ring");
+
+char DebugSystem::ring[DEBUG_RING_BYTES];
+uint32_t DebugSystem::entryStart[DEBUG_BUFFER_SIZE];
+uint32_t DebugSystem::writePos = 0;
+uint32_t DebugSystem::oldest = 0;
+uint32_t DebugSystem::sequence = 0;
+uint32_t DebugSystem::clearSequence = 0;
+portMUX_TYPE DebugSystem::logMux = portMUX_INITIALIZER_UNLOCKED;
+uint8_t DebugSystem::runtimeLevel = LOG_LEVEL;
+
+static constexpr char TAG[] = "debug";
+static const char LEVEL_CHARS[] = "-EWIDT";
 
 void DebugSystem::init() {
-    for (int i = 0; i < DEBUG_BUFFER_SIZE; i++) {
-        debugMessages[i] = "";
+    LOG_I(TAG, "Debug system initialized (level %s, compiled %s, %s)", levelName(runtimeLevel),
+          levelName(LOG_LEVEL), LOG_BINARY ? "binary" : "text");
+}
+
+// "12s W sensor: " 형식의 머리
+size_t DebugSystem::formatPrefix(char* line, uint8_t level, const char* tag) {
+    return snprintf(line, DEBUG_LINE_MAX, "%lus %c %s: ", (unsigned long)(millis() / 1000),
+                    LEVEL_CHARS[min(level, (uint8_t)LOG_LEVEL_TRACE)], tag);
+}
+
+void DebugSystem::write(uint8_t level, const char* tag, const char* format, ...) {
+    char line[DEBUG_LINE_MAX];
+    size_t len = formatPrefix(line, level, tag);
+    
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(line + len, sizeof(line) - len, format, args);
+    va_end(args);
+    if (n > 0) {
+        len += n;
     }
-    log("Debug system initialized");
+    if (len >= sizeof(line)) {
+        len = sizeof(line) - 1;
+    }
+    
+    Serial.println(line);
+    
+    portENTER_CRITICAL(&logMux);
+    append(line, len);
+    portEXIT_CRITICAL(&logMux);
+}
+
+void DebugSystem::checkFormat(const char* format, ...) {
+}
+
+// 바이너리 레코드를 시리얼에 프레임으로 내보내고 링에 저장
+// 머리와 레코드를 한 번에 써야 다른 태스크의 프레임이 그 사이에 끼지 않음 (텍스트 모드의 println과 같음)
+void DebugSystem::commitBinary(BinaryRecord& record) {
+    uint8_t frame[LOG_FRAME_HEADER + sizeof(record.data)];
+    frame[0] = LOG_FRAME_SYNC1;
+    frame[1] = LOG_FRAME_SYNC2;
+    frame[2] = (uint8_t)record.len;
+    memcpy(frame + LOG_FRAME_HEADER, record.data, record.len);
+    Serial.write(frame, LOG_FRAME_HEADER + record.len);
+    
+    portENTER_CRITICAL(&logMux);
+    append(record.data, record.len);
+    portEXIT_CRITICAL(&logMux);
 }
 
-void DebugSystem::log(String message) {
-    String timestamp = String(millis() / 1000) + "s: ";
-    String fullMessage = timestamp + message;
+void DebugSystem::logFromISR(uint8_t level, const char* tag, const char* message) {
+    if (!isEnabled(level)) {
+        return;
+    }
     
-    Serial.println(fullMessage);
+#if LOG_BINARY
+    // 리터럴 메시지만 허용 - ID는 런타임에 같은 해시로 계산
+    BinaryRecord record;
+    record.len = 0;
+    uint32_t id = formatId(tag, message);
+    uint32_t now = millis();
+    record.put(&id, 4);
+    record.put(&now, 4);
+    record.put(&level, 1);
     
-    debugMessages[debugIndex] = fullMessage;
-    debugIndex = (debugIndex + 1) % DEBUG_BUFFER_SIZE;
+    portENTER_CRITICAL_ISR(&logMux);
+    append(record.data, record.len);
+    portEXIT_CRITICAL_ISR(&logMux);
+#else
+    char line[DEBUG_LINE_MAX];
+    size_t len = formatPrefix(line, level, tag);
+    len += strlcpy(line + len, message, sizeof(line) - len);
+    if (len >= sizeof(line)) {
+        len = sizeof(line) - 1;
+    }
+    
+    portENTER_CRITICAL_ISR(&logMux);
+    append(line, len);
+    portEXIT_CRITICAL_ISR(&logMux);
+#endif
 }
 
-String DebugSystem::getLog() {
-    String log = "";
-    for (int i = 0; i < DEBUG_BUFFER_SIZE; i++) {
-        int idx = (debugIndex + i) % DEBUG_BUFFER_SIZE;
-        if (debugMessages[idx].length() > 0) {
-            log += debugMessages[idx] + "\n";
-        }
+// logMux 안에서 호출 - 줄 수나 바이트가 모자라면 오래된 줄부터 버림
+void DebugSystem::append(const void* data, size_t len) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    while (oldest < sequence &&
+           (sequence - oldest >= DEBUG_BUFFER_SIZE ||
+            writePos + len - entryStart[oldest % DEBUG_BUFFER_SIZE] > DEBUG_RING_BYTES)) {
+        oldest++;
     }
-    return log;
+    
+    entryStart[sequence % DEBUG_BUFFER_SIZE] = writePos;
+    
+    size_t at = writePos & (DEBUG_RING_BYTES - 1);
+    size_t first = min(len, (size_t)DEBUG_RING_BYTES - at);
+    memcpy(ring + at, bytes, first);
+    memcpy(ring, bytes + first, len - first);
+    
+    writePos += len;
+    sequence++;
 }
 
 void DebugSystem::clear() {
-    for (int i = 0; i < DEBUG_BUFFER_SIZE; i++) {
-        debugMessages[i] = "";
+    portENTER_CRITICAL(&logMux);
+    clearSequence = sequence;
+    portEXIT_CRITICAL(&logMux);
+    LOG_I(TAG, "Debug log cleared");
+}
+
+void DebugSystem::setLevel(uint8_t level) {
+    runtimeLevel = min(level, (uint8_t)LOG_LEVEL_TRACE);
+    LOG_I(TAG, "Log level set to %s", levelName(runtimeLevel));
+}
+
+uint8_t DebugSystem::getLevel() {
+    return runtimeLevel;
+}
+
+const char* DebugSystem::levelName(uint8_t level) {
+    switch (level) {
+        case LOG_LEVEL_NONE: return "none";
+        case LOG_LEVEL_ERROR: return "error";
+        case LOG_LEVEL_WARN: return "warn";
+        case LOG_LEVEL_INFO: return "info";
+        case LOG_LEVEL_DEBUG: return "debug";
+        default: return "trace";
     }
-    debugIndex = 0;
-    log("Debug log cleared");
-}
\ No newline at end of file
+}
+
+bool DebugSystem::parseLevel(const String& name, uint8_t& level) {
+    for (uint8_t l = LOG_LEVEL_NONE; l <= LOG_LEVEL_TRACE; l++) {
+        if (name.equalsIgnoreCase(levelName(l))) {
+            level = l;
+            return true;
+        }
+    }
+    return false;
+}
+
+void DebugSystem::beginRead(DebugReader& reader, bool raw) {
+    reader.next = getFirstSequence();
+    reader.end = sequence;
+    reader.raw = raw;
+    reader.lineLen = 0;
+    reader.linePos = 0;
+}
+
+size_t DebugSystem::read(DebugReader& reader, uint8_t* buffer, size_t maxLen) {
+    size_t len = 0;
+    while (len < maxLen) {
+        if (reader.linePos == reader.lineLen) {
+            if (reader.next >= reader.end) {
+                break;
+            }
+            // 읽는 사이 덮어쓴 줄은 건너뜀
+            reader.linePos = 0;
+            if (reader.raw) {
+                size_t n = copyEntry(reader.next++, reader.line + LOG_FRAME_HEADER, DEBUG_LINE_MAX);
+                reader.lineLen = n > 0 ? n + LOG_FRAME_HEADER : 0;
+                reader.line[0] = (char)LOG_FRAME_SYNC1;
+                reader.line[1] = (char)LOG_FRAME_SYNC2;
+                reader.line[2] = (char)n;
+            } else {
+                reader.lineLen = readEntry(reader.next++, reader.line, DEBUG_LINE_MAX);
+                if (reader.lineLen > 0) {
+                    reader.line[reader.lineLen++] = '\n';
+                }
+            }
+            if (reader.lineLen == 0) {
+                continue;
+            }
+        }
+        
+        size_t n = min(reader.lineLen - reader.linePos, maxLen - len);
+        memcpy(buffer + len, reader.line + reader.linePos, n);
+        reader.linePos += n;
+        len += n;
+    }
+    return len;
+}
+
+uint32_t DebugSystem::getSequence() {
+    return sequence;
+}
+
+uint32_t DebugSystem::getFirstSequence() {
+    portENTER_CRITICAL(&logMux);
+    uint32_t first = max(oldest, clearSequence);
+    portEXIT_CRITICAL(&logMux);
+    return first;
+}
+
+uint32_t DebugSystem::getClearSequence() {
+    return clearSequence;
+}
+
+// 링의 원본 바이트를 복사하고 길이를 반환 (이미 덮어썼거나 clear() 이전이면 0)
+size_t DebugSystem::copyEntry(uint32_t seq, void* out, size_t outSize) {
+    size_t len = 0;
+    portENTER_CRITICAL(&logMux);
+    if (seq >= oldest && seq < sequence && seq >= clearSequence) {
+        uint32_t start = entryStart[seq % DEBUG_BUFFER_SIZE];
+        uint32_t end = seq + 1 < sequence ? entryStart[(seq + 1) % DEBUG_BUFFER_SIZE] : writePos;
+        len = min((size_t)(end - start), outSize);
+        
+        size_t at = start & (DEBUG_RING_BYTES - 1);
+        size_t first = min(len, (size_t)DEBUG_RING_BYTES - at);
+        memcpy(out, ring + at, first);
+        memcpy((uint8_t*)out + first, ring, len - first);
+    }
+    portEXIT_CRITICAL(&logMux);
+    return len;
+}
+
+// 줄을 NUL로 끝나는 문자열로 복사하고 길이를 반환
+// 바이너리 모드에서는 포맷 ID만 보여 줌 (전체 내용은 /api/log/raw + tools/log_decode.py)
+size_t DebugSystem::readEntry(uint32_t seq, char* out, size_t outSize) {
+#if LOG_BINARY
+    BinaryRecord record;
+    record.len = copyEntry(seq, record.data, sizeof(record.data));
+    if (record.len < 9) {
+        out[0] = '\0';
+        return 0;
+    }
+    uint32_t id, ms;
+    memcpy(&id, record.data, 4);
+    memcpy(&ms, record.data + 4, 4);
+    uint8_t level = record.data[8];
+    int n = snprintf(out, outSize, "%lus %c #%08x (+%u bytes)", (unsigned long)(ms / 1000),
+                     LEVEL_CHARS[min(level, (uint8_t)LOG_LEVEL_TRACE)], id, (unsigned)(record.len - 9));
+    return n > 0 ? min((size_t)n, outSize - 1) : 0;
+#else
+    size_t len = copyEntry(seq, out, outSize - 1);
+    out[len] = '\0';
+    return len;
+#endif
+}
@@ -2,18 +2,193 @@
 #define DEBUG_SYSTEM_H
 
 #include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include <type_traits>
 #include "config.h"
 
+// 바이너리 로그 프레임: A5 5A <길이> <레코드> (시리얼 출력과 /api/log/raw 공용)
+#define LOG_FRAME_SYNC1 0xA5
+#define LOG_FRAME_SYNC2 0x5A
+#define LOG_FRAME_HEADER 3
+
+// /api/debug, /api/log/raw 청크 응답용 - 한 줄(레코드)씩 꺼내 버퍼에 채움
+struct DebugReader {
+    uint32_t next;                   // 다음에 읽을 번호
+    uint32_t end;                    // 읽기 시작 시점의 sequence
+    bool raw;                        // 텍스트 줄 대신 바이너리 프레임
+    char line[DEBUG_LINE_MAX + LOG_FRAME_HEADER];  // 복사 중인 줄 (개행 또는 프레임 머리 포함)
+    size_t lineLen;
+    size_t linePos;
+};
+
+// 바이너리 레코드: 포맷 ID(4) + 시각 ms(4) + 레벨(1) + 인자
+// 정수는 4바이트(64비트는 8), 실수는 float, 문자열은 길이(1) + 바이트 - 해석은 포맷 문자열 기준
+struct BinaryRecord {
+    uint8_t data[DEBUG_LINE_MAX];
+    size_t len;
+    
+    void put(const void* p, size_t n) {
+        if (len + n <= sizeof(data)) {
+            memcpy(data + len, p, n);
+            len += n;
+        }
+    }
+    
+    template<typename T>
+    typename std::enable_if<std::is_integral<T>::value && sizeof(T) <= 4>::type add(T v) {
+        uint32_t x = (uint32_t)v;
+        put(&x, 4);
+    }
+    
+    template<typename T>
+    typename std::enable_if<std::is_integral<T>::value && sizeof(T) == 8>::type add(T v) {
+        put(&v, 8);
+    }
+    
+    template<typename T>
+    typename std::enable_if<std::is_enum<T>::value>::type add(T v) {
+        add((int32_t)v);
+    }
+    
+    void add(double v) {
+        float f = v;
+        put(&f, 4);
+    }
+    
+    void add(const char* s) {
+        uint8_t n = s ? strnlen(s, LOG_BINARY_STR_MAX) : 0;
+        put(&n, 1);
+        put(s, n);
+    }
+    
+    void addAll() {}
+    
+    template<typename T, typename... Rest>
+    void addAll(T first, Rest... rest) {
+        add(first);
+        addAll(rest...);
+    }
+};
+
+// 미리 잡아 둔 바이트 링에 로그를 기록 (로그 호출마다 힙 할당 없음)
+// 줄은 스택 버퍼에서 포맷한 뒤 짧은 임계 구역 안에서 복사 - 다른 코어/태스크/ISR에서 호출 가능
 class DebugSystem {
 private:
-    static String debugMessages[DEBUG_BUFFER_SIZE];
-    static int debugIndex;
+    static char ring[DEBUG_RING_BYTES];
+    static uint32_t entryStart[DEBUG_BUFFER_SIZE];  // 번호 % DEBUG_BUFFER_SIZE -> 링 절대 위치
+    static uint32_t writePos;        // 다음 줄을 쓸 링 절대 위치
+    static uint32_t oldest;          // 링에 남아 있는 가장 오래된 번호
+    static uint32_t sequence;        // 지금까지 기록된 메시지 수 (다음 메시지 번호)
+    static uint32_t clearSequence;   // 마지막 clear() 시점의 sequence
+    static portMUX_TYPE logMux;
+    static uint8_t runtimeLevel;
+    
+    static size_t formatPrefix(char* line, uint8_t level, const char* tag);
+    static void append(const void* data, size_t len);
+    static size_t copyEntry(uint32_t seq, void* out, size_t outSize);
+    static void commitBinary(BinaryRecord& record);
     
 public:
     static void init();
-    static void log(String message);
-    static String getLog();
+    
+    // LOG_E/W/I/D/T 매크로에서 호출 - 직접 쓰지 말고 매크로 사용
+    static void write(uint8_t level, const char* tag, const char* format, ...) __attribute__((format(printf, 3, 4)));
+    
+    template<typename... Args>
+    static void writeBinary(uint8_t level, uint32_t formatId, Args... args) {
+        BinaryRecord record;
+        record.len = 0;
+        uint32_t now = millis();
+        record.put(&formatId, 4);
+        record.put(&now, 4);
+        record.put(&level, 1);
+        record.addAll(args...);
+        commitBinary(record);
+    }
+    
+    // 컴파일러 형식 검사 전용 (호출되지 않음)
+    static void checkFormat(const char* format, ...) __attribute__((format(printf, 1, 2)));
+    
+    // 포맷 ID = FNV-1a("tag:format") - tools/log_strings.py 와 같은 계산
+    static constexpr uint32_t fnv1a(const char* s, uint32_t hash = 2166136261u) {
+        return *s ? fnv1a(s + 1, (hash ^ (uint8_t)*s) * 16777619u) : hash;
+    }
+    static constexpr uint32_t formatId(const char* tag, const char* format) {
+        return fnv1a(format, fnv1a(":", fnv1a(tag)));
+    }
+    
+    static void logFromISR(uint8_t level, const char* tag, const char* message);  // 시리얼 출력 없이 링에만 기록
     static void clear();
+    
+    // 실행 중 레벨 조정 (LOG_LEVEL로 컴파일된 레벨까지만 의미 있음)
+    static inline bool isEnabled(uint8_t level) { return level <= runtimeLevel; }
+    static void setLevel(uint8_t level);
+    static uint8_t getLevel();
+    static const char* levelName(uint8_t level);
+    static bool parseLevel(const String& name, uint8_t& level);
+    
+    // 저장된 로그 전체를 한 번에 만들지 않고 스트리밍 (raw = 바이너리 프레임, LOG_BINARY 빌드 전용)
+    static void beginRead(DebugReader& reader, bool raw = false);
+    static size_t read(DebugReader& reader, uint8_t* buffer, size_t maxLen);
+    
+    // 이벤트 스트림용 - 번호로 새 메시지만 꺼냄
+    static uint32_t getSequence();
+    static uint32_t getFirstSequence();  // 아직 읽을 수 있는 가장 오래된 번호
+    static uint32_t getClearSequence();
+    static size_t readEntry(uint32_t seq, char* out, size_t outSize);
 };
 
-#endif // DEBUG_SYSTEM_H
\ No newline at end of file
+// 레벨별 로그 매크로 - 모듈마다 static constexpr char TAG[] = "module"; 을 두고 LOG_I(TAG, "fmt", ...)
+// 컴파일 레벨 밖의 문장은 빈 문장이 되고, 실행 중 레벨 밖이면 인자를 평가하지 않음
+// 포맷은 문자열 리터럴이어야 함 (바이너리 모드에서 컴파일 시 ID로 바뀜)
+#if LOG_BINARY
+#define LOG_AT(level, tag, format, ...) \
+    do { \
+        if (DebugSystem::isEnabled(level)) { \
+            DebugSystem::writeBinary(level, \
+                std::integral_constant<uint32_t, DebugSystem::formatId(tag, format)>::value, ##__VA_ARGS__); \
+        } \
+        if (0) { \
+            DebugSystem::checkFormat(format, ##__VA_ARGS__); \
+        } \
+    } while (0)
+#else
+#define LOG_AT(level, tag, format, ...) \
+    do { \
+        if (DebugSystem::isEnabled(level)) { \
+            DebugSystem::write(level, tag, format, ##__VA_ARGS__); \
+        } \
+    } while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_E(tag, format, ...) LOG_AT(LOG_LEVEL_ERROR, tag, format, ##__VA_ARGS__)
+#else
+#define LOG_E(tag, format, ...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_W(tag, format, ...) LOG_AT(LOG_LEVEL_WARN, tag, format, ##__VA_ARGS__)
+#else
+#define LOG_W(tag, format, ...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_I(tag, format, ...) LOG_AT(LOG_LEVEL_INFO, tag, format, ##__VA_ARGS__)
+#else
+#define LOG_I(tag, format, ...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_D(tag, format, ...) LOG_AT(LOG_LEVEL_DEBUG, tag, format, ##__VA_ARGS__)
+#else
+#define LOG_D(tag, format, ...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_TRACE
+#define LOG_T(tag, format, ...) LOG_AT(LOG_LEVEL_TRACE, tag, format, ##__VA_ARGS__)
+#else
+#define LOG_T(tag, format, ...) do {} while (0)
+#endif
+
+#endif // DEBUG_SYSTEM_H
@@ -0,0 +1,166 @@
+#include "event_stream.h"
+#include "debug_system.h"
+#include "web_server.h"
+
+AsyncEventSource EventStream::events("/events");
+TaskHandle_t EventStream::eventTask = nullptr;
+uint32_t EventStream::logSequence = 0;
+uint32_t EventStream::clearSequence = 0;
+JsonDocument EventStream::lastStatus;
+unsigned long EventStream::lastStatusCheck = 0;
+unsigned long EventStream::lastSend = 0;
+uint32_t EventStream::eventsBroadcast = 0;
+uint32_t EventStream::consolesConnected = 0;
+
+void EventStream::init(AsyncWebServer& server) {
+    if (eventTask != nullptr) {
+        return;
+    }
+
+    logSequence = DebugSystem::getSequence();
+    clearSequence = DebugSystem::getClearSequence();
+
+    events.onConnect(onConnect);
+    server.addHandler(&events);
+
+    // 변경 감지는 별도 태스크에서 - 센서/카메라 태스크와 무관하게 푸시
+    xTaskCreatePinnedToCore(eventLoop, "events", 6144, nullptr, 1, &eventTask, 0);
+}
+
+bool EventStream::isRunning() {
+    return eventTask != nullptr;
+}
+
+int EventStream::clientCount() {
+    return events.count();
+}
+
+void EventStream::eventLoop(void* param) {
+    for (;;) {
+        if (clientCount() > 0) {
+            pushLogs();
+
+            if (millis() - lastStatusCheck >= EVENTS_STATUS_INTERVAL) {
+                lastStatusCheck = millis();
+                pushStatus();
+            }
+
+            // 프록시/브라우저가 유휴 연결을 끊지 않도록
+            if (millis() - lastSend >= EVENTS_KEEPALIVE) {
+                broadcast("ping", "");
+            }
+        } else {
+            // 아무도 없으면 따라가기만 함 (새 콘솔은 접속 시 전체 스냅샷을 받음)
+            logSequence = DebugSystem::getSequence();
+            clearSequence = DebugSystem::getClearSequence();
+        }
+
+        vTaskDelay(pdMS_TO_TICKS(EVENTS_POLL_INTERVAL));
+    }
+}
+
+void EventStream::onConnect(AsyncEventSourceClient* client) {
+    if (clientCount() > EVENTS_MAX_CLIENTS) {
+        client->close();
+        return;
+    }
+
+    // 새 콘솔에는 전체 상태를 먼저, 버퍼의 로그는 한 이벤트로 묶어서 보냄
+    // (ACK 전에 클라이언트 큐 한도를 넘는 메시지는 버려지므로 메시지 수를 2개로 유지)
+    JsonDocument status;
+    WebServerManager::buildStatusDocument(status);
+    String data;
+    serializeJson(status, data);
+    client->send(data.c_str(), "status");
+
+    uint32_t end = DebugSystem::getSequence();
+    uint32_t start = DebugSystem::getFirstSequence();
+    if (end - start > EVENTS_REPLAY_LINES) {
+        start = end - EVENTS_REPLAY_LINES;
+    }
+
+    String backlog;
+    backlog.reserve((end - start) * 64);
+    char line[DEBUG_LINE_MAX];
+    for (uint32_t seq = start; seq < end; seq++) {
+        if (DebugSystem::readEntry(seq, line, sizeof(line)) > 0) {
+            if (backlog.length() > 0) {
+                backlog += '\n';
+            }
+            backlog += line;
+        }
+    }
+    if (backlog.length() > 0) {
+        client->send(backlog.c_str(), "log");  // 여러 줄은 data: 줄로 나뉘어 가고 페이지에서 다시 분리
+    }
+    consolesConnected++;
+}
+
+void EventStream::pushLogs() {
+    uint32_t clearSeq = DebugSystem::getClearSequence();
+    if (clearSeq != clearSequence) {
+        clearSequence = clearSeq;
+        broadcast("clear", "");
+    }
+
+    uint32_t end = DebugSystem::getSequence();
+    uint32_t start = max(logSequence, DebugSystem::getFirstSequence());  // 그 사이 덮어쓴 줄은 건너뜀
+    logSequence = end;
+    if (start >= end) {
+        return;
+    }
+    if (end - start > EVENTS_REPLAY_LINES) {
+        start = end - EVENTS_REPLAY_LINES;  // 페이지도 이만큼만 보관
+    }
+
+    // 한 번 확인한 줄은 한 이벤트로 묶어서 (줄마다 보내면 부팅/진단 같은 폭주 때 클라이언트 큐 한도를 넘어 버려짐)
+    String batch;
+    batch.reserve((end - start) * 64);
+    char line[DEBUG_LINE_MAX];
+    for (uint32_t seq = start; seq < end; seq++) {
+        if (DebugSystem::readEntry(seq, line, sizeof(line)) > 0) {
+            if (batch.length() > 0) {
+                batch += '\n';
+            }
+            batch += line;
+        }
+    }
+    if (batch.length() > 0) {
+        broadcast("log", batch.c_str());
+    }
+}
+
+void EventStream::pushStatus() {
+    JsonDocument current;
+    WebServerManager::buildStatusDocument(current);
+
+    // 최상위 필드 단위로 바뀐 것만 보냄
+    JsonDocument delta;
+    for (JsonPair kv : current.as<JsonObject>()) {
+        if (lastStatus[kv.key()] != kv.value()) {
+            delta[kv.key()] = kv.value();
+        }
+    }
+    lastStatus = current;
+
+    if (delta.size() > 0) {
+        String data;
+        serializeJson(delta, data);
+        broadcast("status", data.c_str());
+    }
+}
+
+void EventStream::broadcast(const char* event, const char* data) {
+    events.send(data, event);
+    eventsBroadcast++;
+    lastSend = millis();
+}
+
+void EventStream::getStats(JsonObject obj) {
+    obj["running"] = isRunning();
+    obj["clients"] = clientCount();
+    obj["maxClients"] = EVENTS_MAX_CLIENTS;
+    obj["consolesConnected"] = consolesConnected;
+    obj["eventsBroadcast"] = eventsBroadcast;
+    obj["avgPacketsWaiting"] = events.avgPacketsWaiting();
+}
@@ -0,0 +1,37 @@
+#ifndef EVENT_STREAM_H
+#define EVENT_STREAM_H
+
+#include <ESPAsyncWebServer.h>
+#include <ArduinoJson.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "config.h"
+
+// 웹 서버의 /events 에서 Server-Sent Events 제공
+// 새 로그 줄과 바뀐 상태 필드만 모든 콘솔에 푸시 - 브라우저마다 2초 폴링하던 것을 대체
+class EventStream {
+private:
+    static AsyncEventSource events;
+    static TaskHandle_t eventTask;
+    static uint32_t logSequence;
+    static uint32_t clearSequence;
+    static JsonDocument lastStatus;
+    static unsigned long lastStatusCheck;
+    static unsigned long lastSend;
+    static uint32_t eventsBroadcast;
+    static uint32_t consolesConnected;
+
+    static void eventLoop(void* param);
+    static void onConnect(AsyncEventSourceClient* client);
+    static void pushLogs();
+    static void pushStatus();
+    static void broadcast(const char* event, const char* data);
+
+public:
+    static void init(AsyncWebServer& server);
+    static bool isRunning();
+    static int clientCount();
+    static void getStats(JsonObject obj);
+};
+
+#endif // EVENT_STREAM_H
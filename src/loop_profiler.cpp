@@ -0,0 +1,90 @@
+#include "loop_profiler.h"
+#include <algorithm>
+#include <math.h>
+
+ProfileStageData LoopProfiler::stages[PROFILE_STAGE_COUNT];
+portMUX_TYPE LoopProfiler::mux = portMUX_INITIALIZER_UNLOCKED;
+
+const char* LoopProfiler::stageName(ProfileStage stage) {
+    switch (stage) {
+        case PROFILE_LOOP: return "cycle";
+        case PROFILE_JOBS: return "jobs";
+        case PROFILE_SENSOR: return "sensor";
+        case PROFILE_WIFI: return "wifi";
+        case PROFILE_SNAPSHOT: return "snapshot";
+        case PROFILE_SCHEDULER: return "scheduler";
+        default: return "unknown";
+    }
+}
+
+void LoopProfiler::summarize(ProfileStage stage, ProfileSummary& out) {
+    uint32_t window[PROFILE_WINDOW];
+    
+    // 복사만 임계 구역에서 - 정렬은 밖에서
+    portENTER_CRITICAL(&mux);
+    const ProfileStageData& s = stages[stage];
+    uint32_t n = min(s.count, (uint32_t)PROFILE_WINDOW);
+    uint32_t newest = s.count > 0 ? s.samples[(s.count - 1) % PROFILE_WINDOW] : 0;
+    out.count = s.count;
+    out.worst = s.worst;
+    memcpy(window, s.samples, n * sizeof(uint32_t));
+    portEXIT_CRITICAL(&mux);
+    
+    // 사이클 -> us
+    float mhz = ESP.getCpuFreqMHz();
+    out.samples = n;
+    out.last = newest / mhz;
+    out.worst /= mhz;
+    out.mean = out.p99 = out.max = out.jitter = 0;
+    if (n > 0) {
+        double sum = 0, sumSq = 0;
+        for (uint32_t i = 0; i < n; i++) {
+            sum += window[i];
+            sumSq += (double)window[i] * window[i];
+        }
+        double mean = sum / n;
+        std::sort(window, window + n);
+        
+        out.mean = mean / mhz;
+        out.max = window[n - 1] / mhz;
+        out.p99 = window[(n * 99 + 99) / 100 - 1] / mhz;
+        out.jitter = sqrt(max(sumSq / n - mean * mean, 0.0)) / mhz;
+    }
+}
+
+void LoopProfiler::reset() {
+    portENTER_CRITICAL(&mux);
+    memset(stages, 0, sizeof(stages));
+    portEXIT_CRITICAL(&mux);
+}
+
+void LoopProfiler::getStats(JsonObject obj) {
+    obj["window"] = PROFILE_WINDOW;
+    obj["cpuMHz"] = ESP.getCpuFreqMHz();
+    JsonObject stageObj = obj["stages"].to<JsonObject>();
+    
+    ProfileSummary sum;
+    for (int i = 0; i < PROFILE_STAGE_COUNT; i++) {
+        summarize((ProfileStage)i, sum);
+        JsonObject st = stageObj[stageName((ProfileStage)i)].to<JsonObject>();
+        st["count"] = sum.count;
+        st["lastUs"] = sum.last;
+        st["meanUs"] = sum.mean;
+        st["p99Us"] = sum.p99;
+        st["maxUs"] = sum.max;
+        st["jitterUs"] = sum.jitter;
+        st["worstUs"] = sum.worst;
+    }
+}
+
+void LoopProfiler::printReport(Print& out) {
+    out.printf("---- task stage profile (last %d runs, us) ----\n", PROFILE_WINDOW);
+    out.printf("%-10s %8s %9s %9s %9s %9s %9s\n", "stage", "count", "mean", "p99", "max", "jitter", "worst");
+    
+    ProfileSummary sum;
+    for (int i = 0; i < PROFILE_STAGE_COUNT; i++) {
+        summarize((ProfileStage)i, sum);
+        out.printf("%-10s %8u %9.1f %9.1f %9.1f %9.1f %9.1f\n", stageName((ProfileStage)i),
+                   sum.count, sum.mean, sum.p99, sum.max, sum.jitter, sum.worst);
+    }
+}
@@ -0,0 +1,75 @@
+#ifndef LOOP_PROFILER_H
+#define LOOP_PROFILER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "config.h"
+
+// 앱 태스크 안의 측정 단계
+enum ProfileStage {
+    PROFILE_LOOP,        // sensors 태스크 한 주기 전체 (대기 제외)
+    PROFILE_JOBS,        // WebJobs::runSensorJobs
+    PROFILE_SENSOR,      // SensorManager::update
+    PROFILE_WIFI,        // WiFi 연결 확인 (net 태스크)
+    PROFILE_SNAPSHOT,    // 카메라 스냅샷 캡처 + 큐 투입 (camera 태스크)
+    PROFILE_SCHEDULER,   // Scheduler::tick - 예약 작업 (텔레메트리 수집, 스냅샷 신호 등)
+    PROFILE_STAGE_COUNT
+};
+
+// 단계별 최근 PROFILE_WINDOW 회 실행 시간(CPU 사이클)과 부팅 후 최악값
+struct ProfileStageData {
+    uint32_t samples[PROFILE_WINDOW];
+    uint32_t count;          // 지금까지 기록 수 (다음 칸 = count % PROFILE_WINDOW)
+    uint32_t worst;
+};
+
+// 창 단위 요약 (us)
+struct ProfileSummary {
+    uint32_t count;
+    uint32_t samples;        // 창에 든 기록 수
+    float last;
+    float mean;
+    float p99;
+    float max;
+    float jitter;            // 표준편차
+    float worst;
+};
+
+// 단계별 실행 시간 - 기록은 각 앱 태스크, 조회는 웹 핸들러/시리얼 명령에서
+class LoopProfiler {
+private:
+    static ProfileStageData stages[PROFILE_STAGE_COUNT];
+    static portMUX_TYPE mux;
+    
+public:
+    // 조회 쪽(다른 코어)이 창을 복사하는 동안 어긋나지 않도록 짧은 임계 구역 안에서 기록
+    static inline void record(ProfileStage stage, uint32_t cycles) {
+        ProfileStageData& s = stages[stage];
+        portENTER_CRITICAL(&mux);
+        s.samples[s.count % PROFILE_WINDOW] = cycles;
+        s.count++;
+        if (cycles > s.worst) {
+            s.worst = cycles;
+        }
+        portEXIT_CRITICAL(&mux);
+    }
+    
+    static const char* stageName(ProfileStage stage);
+    static void summarize(ProfileStage stage, ProfileSummary& out);
+    static void reset();
+    static void getStats(JsonObject obj);
+    static void printReport(Print& out);
+};
+
+// 범위 계측 - 생성부터 소멸까지의 CPU 사이클을 기록 (태스크가 코어에 고정돼 있어 같은 코어의 카운터끼리 뺌)
+class ProfileScope {
+private:
+    ProfileStage stage;
+    uint32_t start;
+    
+public:
+    explicit ProfileScope(ProfileStage stage) : stage(stage), start(ESP.getCycleCount()) {}
+    ~ProfileScope() { LoopProfiler::record(stage, ESP.getCycleCount() - start); }
+};
+
+#endif // LOOP_PROFILER_H
@@ -5,23 +5,26 @@
  */
 
 #include <Arduino.h>
-#include <HTTPClient.h>
-#include <ArduinoJson.h>
 #include "config.h"
+#include "status_store.h"
 #include "wifi_manager.h"
 #include "web_server.h"
 #include "debug_system.h"
 #include "sensor_manager.h"
 #include "camera_manager.h"
+#include "stream_server.h"
+#include "upload_pipeline.h"
+#include "temp_history.h"
+#include "backend_client.h"
+#include "loop_profiler.h"
+#include "app_tasks.h"
+#include "scheduler.h"
 
-// System status
-SystemStatus sysStatus;
+static constexpr char TAG[] = "main";
 
 // Function declarations
 void initSystemStatus();
 void printSystemInfo();
-void sendDataToAPI();
-void sendCameraSnapshot();
 
 void setup() {
     Serial.begin(115200);
@@ -47,9 +50,16 @@ void setup() {
     
     // 디버그 시스템 초기화
     DebugSystem::init();
-    DebugSystem::log("System initialization started");
+    LOG_I(TAG, "System initialization started");
     
-    // 센서 초기화
+    // 태스크 간 이벤트 그룹 (WiFi 연결 상태 등)
+    AppTasks::init();
+    
+    // 주기 작업 타이머 휠 (각 모듈이 init()에서 작업 등록)
+    Scheduler::init();
+    
+    // 온도 기록 저장소 (PSRAM) 및 센서 초기화
+    TempHistory::init();
     SensorManager::init();
     
     // 카메라 초기화 (옵션)
@@ -60,9 +70,21 @@ void setup() {
     // WiFi Manager 초기화
     WiFiManager::init();
     
-    // 웹 서버 시작
+    // 비동기 웹 서버 시작 (콘솔 이벤트 스트림 /events 포함)
     WebServerManager::init();
     
+    // MJPEG 스트림 서버 시작 (포트 81)
+    if (StatusStore::cameraInitialized()) {
+        StreamServer::init();
+    }
+    
+    // 백엔드 연결 풀 및 업로드 파이프라인 시작 (스냅샷, 온도 데이터)
+    BackendClient::init();
+    UploadPipeline::init();
+    
+    // 센서/카메라(코어 1), WiFi(코어 0) 태스크 시작 - 이후 loop()는 시리얼 명령만 처리
+    AppTasks::startAll();
+    
     // 시스템 준비 완료
     Serial.println("\n=====================================");
     Serial.println("       🟢 System Ready! 🟢          ");
@@ -71,41 +93,25 @@ void setup() {
     Serial.println("=====================================\n");
     
     // 초기 상태 로그
-    DebugSystem::log("System ready - Camera: " + String(sysStatus.cameraInitialized ? "OK" : "FAIL") + 
-                     ", Temp: " + String(sysStatus.tempSensorFound ? "OK" : "FAIL"));
+    LOG_I(TAG, "System ready - Camera: %s, Temp: %s",
+          StatusStore::cameraInitialized() ? "OK" : "FAIL", StatusStore::tempSensorFound() ? "OK" : "FAIL");
 }
 
 void loop() {
-    // 웹 서버 처리
-    WebServerManager::handle();
-    
-    // 센서 업데이트
-    SensorManager::update();
-    
-    // WiFi 상태 체크 (30초마다)
-    static unsigned long lastWiFiCheck = 0;
-    if (millis() - lastWiFiCheck > 30000) {
-        lastWiFiCheck = millis();
-        WiFiManager::checkConnection();
-    }
-    
-    // 카메라 스냅샷 전송 (5초마다)
-    static unsigned long lastCameraCapture = 0;
-    if (sysStatus.wifiConnected && ENABLE_CAMERA && sysStatus.cameraInitialized) {
-        if (millis() - lastCameraCapture > 5000) {  // 5초 간격
-            lastCameraCapture = millis();
-            sendCameraSnapshot();
+    // 시리얼 명령: p = 단계별 프로파일 출력, r = 초기화, t = 태스크 보고
+    if (Serial.available()) {
+        char cmd = Serial.read();
+        if (cmd == 'p') {
+            LoopProfiler::printReport(Serial);
+        } else if (cmd == 'r') {
+            LoopProfiler::reset();
+            Serial.println("Loop profile reset");
+        } else if (cmd == 't') {
+            AppTasks::printReport(Serial);
         }
     }
     
-    // 온도 데이터 전송 (10초마다 - 테스트용으로 빠르게 설정)
-    static unsigned long lastApiSend = 0;
-    if (sysStatus.wifiConnected && millis() - lastApiSend > 10000) {
-        lastApiSend = millis();
-        sendDataToAPI();
-    }
-    
-    delay(10);
+    delay(50);
 }
 
 void initSystemStatus() {
@@ -114,19 +120,12 @@ void initSystemStatus() {
     WiFi.macAddress(mac);
     char deviceId[20];
     sprintf(deviceId, "PETEYE_%02X%02X%02X", mac[3], mac[4], mac[5]);
-    sysStatus.deviceId = String(deviceId);
+    StatusStore::setDeviceId(String(deviceId));
     
-    Serial.println("Device ID: " + sysStatus.deviceId);
+    Serial.println("Device ID: " + StatusStore::deviceId());
     Serial.println("=====================================\n");
     
-    // 상태 초기화
-    sysStatus.wifiConnected = false;
-    sysStatus.cameraInitialized = false;
-    sysStatus.tempSensorFound = false;
-    sysStatus.mpuConnected = false;
-    sysStatus.currentTemp = 0.0;
-    sysStatus.lastTempRead = 0;
-    sysStatus.lastApiUpdate = 0;
+    // 나머지 상태는 StatusStore가 0/false로 시작
 }
 
 void printSystemInfo() {
@@ -138,6 +137,10 @@ void printSystemInfo() {
         Serial.println("\n1. Connect to the WiFi network above");
         Serial.println("2. Open browser and go to IP address");
         Serial.println("3. Configure your home WiFi");
+    } else if (!StatusStore::wifiConnected()) {
+        Serial.println("📶 Connecting to WiFi in background...");
+        Serial.println("   IP will be logged once connected");
+        Serial.println("   mDNS: http://" + String(DEVICE_NAME) + ".local");
     } else {
         Serial.println("📶 Connected to WiFi:");
         Serial.println("   IP: http://" + WiFi.localIP().toString());
@@ -148,100 +151,3 @@ void printSystemInfo() {
         Serial.println("   " + String(API_BASE_URL));
     }
 }
-
-void sendDataToAPI() {
-    if (!sysStatus.wifiConnected) {
-        DebugSystem::log("Cannot send temperature - WiFi not connected");
-        return;
-    }
-    
-    HTTPClient http;
-    String url = String(API_BASE_URL) + "/temperature";
-    
-    DebugSystem::log("Sending temperature to: " + url);
-    
-    http.begin(url);
-    http.addHeader("Content-Type", "application/json");
-    http.setTimeout(API_TIMEOUT);
-    
-    JsonDocument doc;
-    doc["device_id"] = sysStatus.deviceId;
-    doc["temperature"] = sysStatus.currentTemp;
-    doc["timestamp"] = millis() / 1000;
-    doc["rssi"] = WiFi.RSSI();
-    doc["free_heap"] = ESP.getFreeHeap();
-    
-    String jsonData;
-    serializeJson(doc, jsonData);
-    
-    DebugSystem::log("Payload: " + jsonData);
-    
-    int httpCode = http.POST(jsonData);
-    
-    if (httpCode > 0) {
-        if (httpCode == HTTP_CODE_OK) {
-            String response = http.getString();
-            DebugSystem::log("✅ Temperature sent: " + String(sysStatus.currentTemp, 1) + "°C");
-        } else {
-            DebugSystem::log("❌ HTTP error code: " + String(httpCode));
-        }
-    } else {
-        DebugSystem::log("❌ HTTP POST failed: " + http.errorToString(httpCode));
-    }
-    
-    http.end();
-}
-
-void sendCameraSnapshot() {
-    if (!CameraManager::isInitialized()) {
-        DebugSystem::log("Camera not initialized - skipping snapshot");
-        return;
-    }
-    
-    // 카메라 프레임 캡처
-    camera_fb_t* fb = CameraManager::capture();
-    if (!fb) {
-        DebugSystem::log("❌ Failed to capture frame");
-        return;
-    }
-    
-    DebugSystem::log("📸 Captured frame: " + String(fb->len) + " bytes, " + 
-                     String(fb->width) + "x" + String(fb->height));
-    
-    HTTPClient http;
-    String url = String(API_BASE_URL) + "/upload";
-    
-    http.begin(url);
-    http.addHeader("Content-Type", "image/jpeg");
-    http.addHeader("X-Device-ID", sysStatus.deviceId);
-    http.addHeader("X-Timestamp", String(millis()));
-    http.addHeader("X-Temperature", String(sysStatus.currentTemp, 1));
-    http.addHeader("X-RSSI", String(WiFi.RSSI()));
-    http.addHeader("X-Free-Heap", String(ESP.getFreeHeap()));
-    http.setTimeout(15000);  // 15초 타임아웃 (이미지는 크므로)
-    
-    DebugSystem::log("Sending image to: " + url);
-    
-    // 바이너리 이미지 데이터 직접 전송
-    int httpCode = http.POST(fb->buf, fb->len);
-    
-    if (httpCode > 0) {
-        if (httpCode == HTTP_CODE_OK) {
-            String response = http.getString();
-            DebugSystem::log("✅ Image sent successfully");
-            
-            // 성공 시 LED 깜빡임 (옵션)
-            pinMode(4, OUTPUT);  // 내장 LED (있는 경우)
-            digitalWrite(4, HIGH);
-            delay(100);
-            digitalWrite(4, LOW);
-        } else {
-            DebugSystem::log("❌ Image upload failed - HTTP code: " + String(httpCode));
-        }
-    } else {
-        DebugSystem::log("❌ Image POST failed: " + http.errorToString(httpCode));
-    }
-    
-    http.end();
-    CameraManager::releaseFrame(fb);
-}
\ No newline at end of file
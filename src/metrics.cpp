@@ -0,0 +1,116 @@
+#include "metrics.h"
+#include <WiFi.h>
+
+Metric* Metrics::head = nullptr;
+Metric* Metrics::tail = nullptr;
+
+MetricGauge Metrics::heapFree("peteye_heap_free_bytes", "Free internal heap");
+MetricGauge Metrics::heapMinFree("peteye_heap_min_free_bytes", "Lowest free internal heap since boot");
+MetricGauge Metrics::psramFree("peteye_psram_free_bytes", "Free PSRAM");
+MetricGauge Metrics::psramMinFree("peteye_psram_min_free_bytes", "Lowest free PSRAM since boot");
+MetricGauge Metrics::uptime("peteye_uptime_seconds", "Seconds since boot");
+MetricGauge Metrics::rssi("peteye_wifi_rssi_dbm", "WiFi signal strength");
+
+Metric::Metric(const char* name, const char* help, MetricType type,
+               const char* labelName, const char* labelValue)
+    : name(name), help(help), labelName(labelName), labelValue(labelValue), type(type), next(nullptr) {
+    Metrics::add(this);
+}
+
+MetricHistogram::MetricHistogram(const char* name, const char* help, const uint32_t* bounds, uint8_t boundCount,
+                                 const char* labelName, const char* labelValue)
+    : Metric(name, help, METRIC_HISTOGRAM, labelName, labelValue),
+      bounds(bounds), boundCount(min(boundCount, (uint8_t)METRICS_MAX_BUCKETS)), sum(0) {
+    for (uint8_t i = 0; i <= METRICS_MAX_BUCKETS; i++) {
+        buckets[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+// 정적 생성자와 setup()에서만 호출 (단일 태스크) - 목록은 이후 읽기 전용
+void Metrics::add(Metric* metric) {
+    if (tail == nullptr) {
+        head = metric;
+    } else {
+        tail->next = metric;
+    }
+    tail = metric;
+}
+
+// 스크레이프 시점에 읽는 값
+void Metrics::collectSystem() {
+    heapFree.set(ESP.getFreeHeap());
+    heapMinFree.set(ESP.getMinFreeHeap());
+    psramFree.set(ESP.getFreePsram());
+    psramMinFree.set(ESP.getMinFreePsram());
+    uptime.set(millis() / 1000);
+    rssi.set(WiFi.status() == WL_CONNECTED ? WiFi.RSSI() : 0);
+}
+
+void Metrics::writeLabels(Print& out, const Metric* m, const char* le) {
+    if (m->labelName == nullptr && le == nullptr) {
+        return;
+    }
+    out.print('{');
+    if (m->labelName != nullptr) {
+        out.printf("%s=\"%s\"", m->labelName, m->labelValue);
+        if (le != nullptr) {
+            out.print(',');
+        }
+    }
+    if (le != nullptr) {
+        out.printf("le=\"%s\"", le);
+    }
+    out.print('}');
+}
+
+// Prometheus 텍스트 형식 (version 0.0.4)
+void Metrics::write(Print& out) {
+    collectSystem();
+    
+    const char* lastName = "";
+    for (const Metric* m = head; m != nullptr; m = m->next) {
+        if (strcmp(m->name, lastName) != 0) {
+            static const char* TYPE_NAMES[] = {"counter", "gauge", "histogram"};
+            out.printf("# HELP %s %s\n# TYPE %s %s\n", m->name, m->help, m->name, TYPE_NAMES[m->type]);
+            lastName = m->name;
+        }
+        
+        switch (m->type) {
+            case METRIC_COUNTER:
+                out.print(m->name);
+                writeLabels(out, m);
+                out.printf(" %u\n", ((const MetricCounter*)m)->value.load(std::memory_order_relaxed));
+                break;
+                
+            case METRIC_GAUGE:
+                out.print(m->name);
+                writeLabels(out, m);
+                out.printf(" %d\n", ((const MetricGauge*)m)->value.load(std::memory_order_relaxed));
+                break;
+                
+            case METRIC_HISTOGRAM: {
+                const MetricHistogram* h = (const MetricHistogram*)m;
+                uint32_t cumulative = 0;
+                char le[12];
+                for (uint8_t i = 0; i <= h->boundCount; i++) {
+                    cumulative += h->buckets[i].load(std::memory_order_relaxed);
+                    if (i < h->boundCount) {
+                        snprintf(le, sizeof(le), "%u", h->bounds[i]);
+                    } else {
+                        strcpy(le, "+Inf");
+                    }
+                    out.printf("%s_bucket", m->name);
+                    writeLabels(out, m, le);
+                    out.printf(" %u\n", cumulative);
+                }
+                out.printf("%s_sum", m->name);
+                writeLabels(out, m);
+                out.printf(" %llu\n", (unsigned long long)h->sum.load(std::memory_order_relaxed));
+                out.printf("%s_count", m->name);
+                writeLabels(out, m);
+                out.printf(" %u\n", cumulative);
+                break;
+            }
+        }
+    }
+}
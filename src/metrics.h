@@ -0,0 +1,101 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "esp_timer.h"
+#include "config.h"
+
+enum MetricType {
+    METRIC_COUNTER,
+    METRIC_GAUGE,
+    METRIC_HISTOGRAM
+};
+
+// 모든 지표의 공통 부분 - 생성 시 전역 목록에 등록되어 /metrics 에 나감
+// 같은 이름(레이블만 다른) 지표는 연달아 생성해야 HELP/TYPE 줄이 한 번만 나감
+class Metric {
+public:
+    const char* name;
+    const char* help;
+    const char* labelName;    // 레이블 하나까지 지원 (없으면 nullptr)
+    const char* labelValue;
+    MetricType type;
+    Metric* next;
+    
+    Metric(const char* name, const char* help, MetricType type,
+           const char* labelName = nullptr, const char* labelValue = nullptr);
+};
+
+// 단조 증가 카운터
+class MetricCounter : public Metric {
+public:
+    std::atomic<uint32_t> value;
+    
+    MetricCounter(const char* name, const char* help,
+                  const char* labelName = nullptr, const char* labelValue = nullptr)
+        : Metric(name, help, METRIC_COUNTER, labelName, labelValue), value(0) {}
+    
+    void inc(uint32_t n = 1) { value.fetch_add(n, std::memory_order_relaxed); }
+};
+
+// 현재 값 (덮어쓰기)
+class MetricGauge : public Metric {
+public:
+    std::atomic<int32_t> value;
+    
+    MetricGauge(const char* name, const char* help,
+                const char* labelName = nullptr, const char* labelValue = nullptr)
+        : Metric(name, help, METRIC_GAUGE, labelName, labelValue), value(0) {}
+    
+    void set(int32_t v) { value.store(v, std::memory_order_relaxed); }
+};
+
+// 고정 버킷 히스토그램 - 관측 한 번에 버킷 검색 + 원자적 덧셈 두 번
+class MetricHistogram : public Metric {
+public:
+    const uint32_t* bounds;   // 오름차순 상한 (le)
+    uint8_t boundCount;
+    std::atomic<uint32_t> buckets[METRICS_MAX_BUCKETS + 1];  // 마지막 칸은 +Inf (누적 아님)
+    std::atomic<uint64_t> sum;  // 32비트면 us 단위 합이 한 시간 남짓에 넘침
+    
+    MetricHistogram(const char* name, const char* help, const uint32_t* bounds, uint8_t boundCount,
+                    const char* labelName = nullptr, const char* labelValue = nullptr);
+    
+    void observe(uint32_t v) {
+        uint8_t i = 0;
+        while (i < boundCount && v > bounds[i]) {
+            i++;
+        }
+        buckets[i].fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(v, std::memory_order_relaxed);
+    }
+    
+    // esp_timer_get_time() 로 잰 시작 시각부터 지금까지 (us)
+    void observeSince(int64_t startUs) {
+        observe((uint32_t)(esp_timer_get_time() - startUs));
+    }
+};
+
+// 지표 목록과 Prometheus 텍스트 출력
+class Metrics {
+private:
+    static Metric* head;
+    static Metric* tail;
+    
+    static MetricGauge heapFree;
+    static MetricGauge heapMinFree;
+    static MetricGauge psramFree;
+    static MetricGauge psramMinFree;
+    static MetricGauge uptime;
+    static MetricGauge rssi;
+    
+    static void writeLabels(Print& out, const Metric* m, const char* le = nullptr);
+    static void collectSystem();
+    
+public:
+    static void add(Metric* metric);
+    static void write(Print& out);
+};
+
+#endif // METRICS_H
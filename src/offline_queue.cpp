@@ -0,0 +1,444 @@
+#include "offline_queue.h"
+#include <LittleFS.h>
+#include <rom/crc.h>
+#include "debug_system.h"
+
+static constexpr char TAG[] = "offline";
+
+static const uint16_t RECORD_MAGIC = 0x0FF1;
+static const uint32_t INDEX_MAGIC = 0x4F464958;  // "OFIX"
+static const char* INDEX_PATH = OFFLINE_DIR "/index";
+
+bool OfflineQueue::flashReady = false;
+OfflineIndex OfflineQueue::index = {};
+uint32_t OfflineQueue::headBytes = 0;
+uint32_t OfflineQueue::tailBytes = 0;
+uint32_t OfflineQueue::flashRecords = 0;
+uint32_t OfflineQueue::recordsSinceIndex = 0;
+OfflineRecord OfflineQueue::memory[OFFLINE_MEMORY_RECORDS];
+uint8_t OfflineQueue::memHead = 0;
+uint8_t OfflineQueue::memCount = 0;
+uint32_t OfflineQueue::memBytes = 0;
+bool OfflineQueue::peekedFromFlash = false;
+uint32_t OfflineQueue::peekedSize = 0;
+unsigned long OfflineQueue::lastFrameStored = 0;
+OfflineStats OfflineQueue::stats = {};
+
+void OfflineQueue::init() {
+    // huge_app.csv의 "spiffs" 파티션을 LittleFS로 사용 (처음이면 포맷)
+    if (!LittleFS.begin(true)) {
+        LOG_E(TAG, "❌ LittleFS mount failed - offline queue is memory only");
+        return;
+    }
+    if (!LittleFS.exists(OFFLINE_DIR)) {
+        LittleFS.mkdir(OFFLINE_DIR);
+    }
+
+    flashReady = true;
+    loadIndex();
+
+    if (flashRecords > 0) {
+        LOG_I(TAG, "Offline queue: %u records pending in %u segments",
+              flashRecords, index.tailSegment - index.headSegment + 1);
+    }
+}
+
+String OfflineQueue::segmentPath(uint32_t segment) {
+    return String(OFFLINE_DIR) + "/seg_" + String(segment) + ".bin";
+}
+
+void OfflineQueue::loadIndex() {
+    bool valid = false;
+    if (LittleFS.exists(INDEX_PATH)) {
+        File f = LittleFS.open(INDEX_PATH, FILE_READ);
+        OfflineIndex saved;
+        valid = f && f.read((uint8_t*)&saved, sizeof(saved)) == sizeof(saved) &&
+                saved.magic == INDEX_MAGIC && saved.headSegment <= saved.tailSegment;
+        f.close();
+        if (valid) {
+            index = saved;
+        }
+    }
+    if (!valid) {
+        scanSegments();
+    }
+
+    // 인덱스 저장 전에 전원이 꺼졌다면 이미 지운 세그먼트를 건너뜀
+    while (index.headSegment < index.tailSegment && !LittleFS.exists(segmentPath(index.headSegment))) {
+        index.headSegment++;
+        index.headOffset = 0;
+    }
+
+    tailBytes = 0;
+    if (LittleFS.exists(segmentPath(index.tailSegment))) {
+        File tail = LittleFS.open(segmentPath(index.tailSegment), FILE_READ);
+        tailBytes = tail.size();
+        tail.close();
+    }
+
+    flashRecords = 0;
+    for (uint32_t segment = index.headSegment; segment <= index.tailSegment; segment++) {
+        flashRecords += countRecords(segment, segment == index.headSegment ? index.headOffset : 0);
+    }
+}
+
+void OfflineQueue::scanSegments() {
+    // 인덱스가 없으면 디렉터리의 세그먼트 번호로 복구 (처음부터 재전송)
+    bool found = false;
+    uint32_t first = 0;
+    uint32_t last = 0;
+
+    File dir = LittleFS.open(OFFLINE_DIR);
+    File entry = dir.openNextFile();
+    while (entry) {
+        String name = entry.name();
+        int start = name.indexOf("seg_");
+        if (start >= 0) {
+            uint32_t segment = name.substring(start + 4).toInt();
+            if (!found || segment < first) {
+                first = segment;
+            }
+            if (!found || segment > last) {
+                last = segment;
+            }
+            found = true;
+        }
+        entry = dir.openNextFile();
+    }
+    dir.close();
+
+    index.magic = INDEX_MAGIC;
+    index.headSegment = first;
+    index.headOffset = 0;
+    index.tailSegment = last;
+}
+
+void OfflineQueue::saveIndex() {
+    File f = LittleFS.open(INDEX_PATH, FILE_WRITE);
+    if (f) {
+        f.write((const uint8_t*)&index, sizeof(index));
+        f.close();
+    }
+    recordsSinceIndex = 0;
+}
+
+uint32_t OfflineQueue::countRecords(uint32_t segment, uint32_t offset) {
+    if (!LittleFS.exists(segmentPath(segment))) {
+        return 0;
+    }
+
+    File f = LittleFS.open(segmentPath(segment), FILE_READ);
+    uint32_t size = f.size();
+    uint32_t count = 0;
+    OfflineRecordHeader header;
+
+    // 헤더만 따라가며 셈 - 잘린 마지막 레코드는 제외
+    while (offset + sizeof(header) <= size) {
+        f.seek(offset);
+        if (f.read((uint8_t*)&header, sizeof(header)) != sizeof(header) || header.magic != RECORD_MAGIC) {
+            break;
+        }
+        offset += sizeof(header) + header.length;
+        if (offset > size) {
+            break;
+        }
+        count++;
+    }
+
+    f.close();
+    return count;
+}
+
+// 카운터가 아니라 읽기/쓰기 위치로 판단 - 카운터가 실제보다 커져도 없는 세그먼트를 계속 열지 않도록
+bool OfflineQueue::flashEmpty() {
+    if (!flashReady) {
+        return true;
+    }
+    if (index.headSegment == index.tailSegment && index.headOffset >= tailBytes) {
+        flashRecords = 0;
+        return true;
+    }
+    return false;
+}
+
+uint8_t* OfflineQueue::allocPayload(size_t len) {
+    return (uint8_t*)(psramFound() ? ps_malloc(len) : malloc(len));
+}
+
+bool OfflineQueue::store(const UploadJob& job) {
+    // 오프라인이 길어져도 스냅샷이 온도 데이터를 밀어내지 않도록 간격 제한
+    if (job.type == UPLOAD_FRAME && lastFrameStored != 0 &&
+        millis() - lastFrameStored < OFFLINE_FRAME_INTERVAL) {
+        stats.framesSkipped++;
+        return false;
+    }
+
+    const uint8_t* payload = job.type == UPLOAD_FRAME ? job.frame->buf : (const uint8_t*)job.body;
+    size_t len = job.type == UPLOAD_FRAME ? job.frame->len : job.bodyLen;
+    if (len + sizeof(OfflineRecordHeader) > OFFLINE_SEGMENT_SIZE || len > OFFLINE_MEMORY_BYTES) {
+        stats.dropped++;
+        return false;
+    }
+
+    // PSRAM 계층이 가득 차면 오래된 레코드부터 플래시로 이동 (플래시가 없으면 버림)
+    while (memCount > 0 && (memCount == OFFLINE_MEMORY_RECORDS || memBytes + len > OFFLINE_MEMORY_BYTES)) {
+        if (!spillOldest()) {
+            freeMemoryHead();
+            stats.dropped++;
+        }
+    }
+
+    uint8_t* data = allocPayload(len);
+    if (data == nullptr) {
+        stats.dropped++;
+        return false;
+    }
+    memcpy(data, payload, len);
+
+    OfflineRecord& record = memory[(memHead + memCount) % OFFLINE_MEMORY_RECORDS];
+    memset(&record.header, 0, sizeof(record.header));
+    record.header.magic = RECORD_MAGIC;
+    record.header.type = job.type;
+    record.header.format = job.format;
+    record.header.length = len;
+    record.header.timestamp = job.type == UPLOAD_FRAME ? job.frame->timestamp : millis();
+    record.header.temperature = job.temperature;
+    record.header.crc = crc32_le(0, data, len);
+    strncpy(record.header.path, job.path, sizeof(record.header.path) - 1);
+    record.data = data;
+    record.storedAt = millis();
+
+    memCount++;
+    memBytes += len;
+    stats.stored++;
+    if (job.type == UPLOAD_FRAME) {
+        lastFrameStored = millis();
+    }
+    return true;
+}
+
+bool OfflineQueue::spillOldest() {
+    if (!flashReady || memCount == 0 || !appendToFlash(memory[memHead])) {
+        return false;
+    }
+    freeMemoryHead();
+    stats.spilled++;
+    return true;
+}
+
+bool OfflineQueue::appendToFlash(const OfflineRecord& record) {
+    uint32_t size = sizeof(record.header) + record.header.length;
+
+    // 세그먼트가 차면 다음 세그먼트로
+    if (tailBytes > 0 && tailBytes + size > OFFLINE_SEGMENT_SIZE) {
+        rollTail();
+    }
+
+    File f = LittleFS.open(segmentPath(index.tailSegment), FILE_APPEND);
+    if (!f) {
+        return false;
+    }
+    uint32_t before = tailBytes;
+    bool ok = f.write((const uint8_t*)&record.header, sizeof(record.header)) == sizeof(record.header) &&
+              f.write(record.data, record.header.length) == record.header.length;
+    tailBytes = f.size();
+    f.close();
+
+    if (ok) {
+        flashRecords++;
+    } else if (tailBytes != before) {
+        // 잘린 레코드 뒤에 이어 쓰지 않도록 새 세그먼트로 (잘린 레코드는 세그먼트 끝에만 남음)
+        LOG_W(TAG, "⚠️ Partial write to offline segment %u - starting a new segment", index.tailSegment);
+        rollTail();
+    }
+    return ok;
+}
+
+// 다음 세그먼트로 - 개수 제한을 넘으면 가장 오래된 세그먼트를 통째로 삭제
+void OfflineQueue::rollTail() {
+    index.tailSegment++;
+    tailBytes = 0;
+    if (index.tailSegment - index.headSegment + 1 > OFFLINE_MAX_SEGMENTS) {
+        uint32_t lost = dropHeadSegment();
+        stats.dropped += lost;
+        LOG_W(TAG, "⚠️ Offline queue full - dropped %u oldest records", lost);
+    }
+    saveIndex();
+}
+
+uint32_t OfflineQueue::dropHeadSegment() {
+    uint32_t lost = countRecords(index.headSegment, index.headOffset);
+    LittleFS.remove(segmentPath(index.headSegment));
+    flashRecords -= min(lost, flashRecords);
+
+    if (index.headSegment == index.tailSegment) {
+        index.tailSegment++;
+        tailBytes = 0;
+    }
+    index.headSegment++;
+    index.headOffset = 0;
+    saveIndex();
+    return lost;
+}
+
+void OfflineQueue::advanceHead(uint32_t size) {
+    index.headOffset += size;
+    if (flashRecords > 0) {
+        flashRecords--;
+    }
+
+    // 다 읽은 세그먼트는 바로 삭제, 그 외에는 N개마다 한 번만 인덱스 저장
+    // (재부팅 시 최대 OFFLINE_INDEX_EVERY개가 중복 전송될 수 있음)
+    if (index.headOffset >= headBytes) {
+        dropHeadSegment();
+    } else if (++recordsSinceIndex >= OFFLINE_INDEX_EVERY) {
+        saveIndex();
+    }
+}
+
+void OfflineQueue::freeMemoryHead() {
+    OfflineRecord& record = memory[memHead];
+    memBytes -= record.header.length;
+    free(record.data);
+    record.data = nullptr;
+    memHead = (memHead + 1) % OFFLINE_MEMORY_RECORDS;
+    memCount--;
+}
+
+bool OfflineQueue::readFlashHead(OfflineRecordHeader& header, uint8_t*& data, bool& corrupt) {
+    data = nullptr;
+    corrupt = false;
+
+    File f = LittleFS.open(segmentPath(index.headSegment), FILE_READ);
+    if (!f) {
+        corrupt = true;
+        return false;
+    }
+    headBytes = f.size();
+
+    bool ok = f.seek(index.headOffset) &&
+              f.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+              header.magic == RECORD_MAGIC &&
+              index.headOffset + sizeof(header) + header.length <= headBytes;
+    if (ok) {
+        data = allocPayload(header.length);
+        if (data == nullptr) {
+            f.close();
+            return false;
+        }
+        ok = f.read(data, header.length) == header.length &&
+             crc32_le(0, data, header.length) == header.crc;
+    }
+    f.close();
+
+    if (!ok) {
+        free(data);
+        data = nullptr;
+        corrupt = true;
+    }
+    return ok;
+}
+
+bool OfflineQueue::buildJob(const OfflineRecordHeader& header, uint8_t* data, UploadJob& job) {
+    memset(&job, 0, sizeof(job));
+    job.type = (UploadType)header.type;
+    job.temperature = header.temperature;
+    strncpy(job.path, header.path, sizeof(job.path) - 1);
+
+    if (job.type == UPLOAD_FRAME) {
+        SharedFrame* frame = new SharedFrame();
+        frame->buf = data;
+        frame->len = header.length;
+        frame->width = 0;
+        frame->height = 0;
+        frame->timestamp = header.timestamp;
+        frame->refs.store(1);
+        job.frame = frame;
+    } else {
+        job.body = (char*)data;
+        job.bodyLen = header.length;
+        job.format = (WireFormat)header.format;
+    }
+    return true;
+}
+
+bool OfflineQueue::peek(UploadJob& job) {
+    // 플래시에는 항상 PSRAM보다 오래된 레코드가 있으므로 플래시부터 꺼냄
+    if (!flashEmpty()) {
+        OfflineRecordHeader header;
+        uint8_t* data;
+        bool corrupt;
+        if (!readFlashHead(header, data, corrupt)) {
+            if (corrupt) {
+                stats.corrupt++;
+                LOG_W(TAG, "⚠️ Offline segment %u corrupt - skipping", index.headSegment);
+                dropHeadSegment();
+            }
+            return false;
+        }
+        peekedFromFlash = true;
+        peekedSize = sizeof(header) + header.length;
+        return buildJob(header, data, job);
+    }
+
+    if (memCount == 0) {
+        return false;
+    }
+
+    // 전송이 실패하면 레코드가 남아 있어야 하므로 사본을 넘김
+    const OfflineRecord& record = memory[memHead];
+    uint8_t* data = allocPayload(record.header.length);
+    if (data == nullptr) {
+        return false;
+    }
+    memcpy(data, record.data, record.header.length);
+    peekedFromFlash = false;
+    return buildJob(record.header, data, job);
+}
+
+void OfflineQueue::pop(bool delivered) {
+    if (peekedFromFlash) {
+        advanceHead(peekedSize);
+    } else if (memCount > 0) {
+        freeMemoryHead();
+    }
+
+    if (delivered) {
+        stats.replayed++;
+    } else {
+        stats.discarded++;
+    }
+}
+
+void OfflineQueue::maintain() {
+    // PSRAM에 오래 머문 레코드는 전원이 꺼져도 남도록 플래시로 이동
+    while (memCount > 0 && millis() - memory[memHead].storedAt > OFFLINE_PERSIST_DELAY) {
+        if (!spillOldest()) {
+            break;
+        }
+    }
+}
+
+uint32_t OfflineQueue::pending() {
+    return flashRecords + memCount;
+}
+
+void OfflineQueue::getStats(JsonObject obj) {
+    obj["pending"] = pending();
+    obj["memoryRecords"] = memCount;
+    obj["memoryBytes"] = memBytes;
+    obj["flashReady"] = flashReady;
+    obj["flashRecords"] = flashRecords;
+    obj["segments"] = flashReady ? index.tailSegment - index.headSegment + 1 : 0;
+    if (flashReady) {
+        obj["flashUsed"] = LittleFS.usedBytes();
+        obj["flashTotal"] = LittleFS.totalBytes();
+    }
+    obj["stored"] = stats.stored;
+    obj["replayed"] = stats.replayed;
+    obj["discarded"] = stats.discarded;
+    obj["dropped"] = stats.dropped;
+    obj["spilled"] = stats.spilled;
+    obj["framesSkipped"] = stats.framesSkipped;
+    obj["corrupt"] = stats.corrupt;
+}
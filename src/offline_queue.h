@@ -0,0 +1,91 @@
+#ifndef OFFLINE_QUEUE_H
+#define OFFLINE_QUEUE_H
+
+#include <ArduinoJson.h>
+#include "config.h"
+#include "upload_pipeline.h"
+
+// 세그먼트 파일에 기록되는 레코드 헤더 (뒤에 payload가 이어짐)
+struct OfflineRecordHeader {
+    uint16_t magic;
+    uint8_t type;         // UploadType
+    uint8_t format;       // WireFormat
+    uint32_t length;      // payload 길이
+    uint32_t timestamp;   // 스냅샷 캡처 시각 (ms)
+    float temperature;
+    uint32_t crc;         // payload CRC32
+    char path[24];
+};
+
+// PSRAM 계층의 레코드
+struct OfflineRecord {
+    OfflineRecordHeader header;
+    uint8_t* data;
+    unsigned long storedAt;
+};
+
+// LittleFS에 저장되는 읽기 위치 (재부팅 후 이어서 재전송)
+struct OfflineIndex {
+    uint32_t magic;
+    uint32_t headSegment;
+    uint32_t headOffset;
+    uint32_t tailSegment;
+};
+
+struct OfflineStats {
+    uint32_t stored;          // 업로드 실패로 보관한 레코드
+    uint32_t replayed;        // 재전송 성공
+    uint32_t discarded;       // 재전송 시 4xx로 버린 레코드
+    uint32_t dropped;         // 용량 초과로 버린 레코드
+    uint32_t framesSkipped;   // OFFLINE_FRAME_INTERVAL 때문에 보관하지 않은 스냅샷
+    uint32_t corrupt;         // CRC 불일치/잘린 레코드
+    uint32_t spilled;         // PSRAM → 플래시로 옮긴 레코드
+};
+
+// 업로드 실패 payload를 보관했다가 연결이 돌아오면 순서대로 재전송하는 큐
+// PSRAM(빠른 계층) → LittleFS 세그먼트(영속 계층) 순으로 쌓고, 플래시의 오래된 것부터 꺼냄
+// 업로드 태스크에서만 호출됨
+class OfflineQueue {
+private:
+    static bool flashReady;
+    static OfflineIndex index;
+    static uint32_t headBytes;
+    static uint32_t tailBytes;
+    static uint32_t flashRecords;
+    static uint32_t recordsSinceIndex;
+    static OfflineRecord memory[OFFLINE_MEMORY_RECORDS];
+    static uint8_t memHead;
+    static uint8_t memCount;
+    static uint32_t memBytes;
+    static bool peekedFromFlash;
+    static uint32_t peekedSize;
+    static unsigned long lastFrameStored;
+    static OfflineStats stats;
+
+    static String segmentPath(uint32_t segment);
+    static void loadIndex();
+    static void scanSegments();
+    static void saveIndex();
+    static uint32_t countRecords(uint32_t segment, uint32_t offset);
+    static bool flashEmpty();
+    static bool spillOldest();
+    static bool appendToFlash(const OfflineRecord& record);
+    static void rollTail();
+    static uint32_t dropHeadSegment();
+    static void advanceHead(uint32_t size);
+    static void freeMemoryHead();
+    static uint8_t* allocPayload(size_t len);
+    static bool readFlashHead(OfflineRecordHeader& header, uint8_t*& data, bool& corrupt);
+    static bool buildJob(const OfflineRecordHeader& header, uint8_t* data, UploadJob& job);
+
+public:
+    static void init();
+    static bool store(const UploadJob& job);
+    static bool peek(UploadJob& job);
+    static void pop(bool delivered);
+    static void maintain();
+    static uint32_t pending();
+    static void getStats(JsonObject obj);
+};
+
+#endif // OFFLINE_QUEUE_H
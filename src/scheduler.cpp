@@ -0,0 +1,306 @@
+#include "scheduler.h"
+#include "debug_system.h"
+
+static constexpr char TAG[] = "sched";
+
+SchedulerJob Scheduler::jobs[SCHED_MAX_JOBS] = {};
+int8_t Scheduler::wheel[SCHED_WHEEL_SLOTS];
+uint32_t Scheduler::currentTick = 0;
+portMUX_TYPE Scheduler::mux = portMUX_INITIALIZER_UNLOCKED;
+Preferences Scheduler::preferences;
+
+// esp_timer 기준 - millis()/10 과 달리 32비트 경계에서 연속으로 넘어감
+static inline uint32_t nowTick() {
+    return (uint32_t)(esp_timer_get_time() / (SCHED_TICK_MS * 1000));
+}
+
+static inline uint32_t toTicks(uint32_t ms) {
+    uint32_t ticks = (ms + SCHED_TICK_MS - 1) / SCHED_TICK_MS;
+    return ticks > 0 ? ticks : 1;  // 이미 지난 칸에 넣으면 한 바퀴 뒤에나 보임
+}
+
+// 작업 등록 전에 호출
+void Scheduler::init() {
+    for (int i = 0; i < SCHED_WHEEL_SLOTS; i++) {
+        wheel[i] = -1;
+    }
+    currentTick = nowTick();
+}
+
+int8_t Scheduler::every(const char* name, uint32_t periodMs, SchedulerCallback callback,
+                        uint32_t firstDelayMs, bool coalesce) {
+    periodMs = loadInterval(name, periodMs);
+
+    portENTER_CRITICAL(&mux);
+    int8_t id = allocate(name);
+    if (id >= 0) {
+        jobs[id].callback = callback;
+        jobs[id].periodMs = periodMs;
+        jobs[id].coalesce = coalesce;
+        arm(id, firstDelayMs);
+    }
+    portEXIT_CRITICAL(&mux);
+
+    if (id < 0) {
+        LOG_E(TAG, "❌ No free job slot for %s", name);
+        return -1;
+    }
+    LOG_I(TAG, "Job %s every %lums", name, (unsigned long)periodMs);
+    return id;
+}
+
+// 한 번만 실행 - 같은 이름이 이미 예약돼 있으면 새 지연으로 다시 예약
+int8_t Scheduler::after(const char* name, uint32_t delayMs, SchedulerCallback callback, bool coalesce) {
+    portENTER_CRITICAL(&mux);
+    int8_t id = allocate(name);
+    if (id >= 0) {
+        jobs[id].callback = callback;
+        jobs[id].periodMs = 0;
+        jobs[id].coalesce = coalesce;
+        arm(id, delayMs);
+    }
+    portEXIT_CRITICAL(&mux);
+
+    if (id < 0) {
+        LOG_E(TAG, "❌ No free job slot for %s", name);
+    }
+    return id;
+}
+
+void Scheduler::cancel(int8_t id) {
+    if (id < 0 || id >= SCHED_MAX_JOBS) {
+        return;
+    }
+
+    portENTER_CRITICAL(&mux);
+    if (jobs[id].queued) {
+        unlink(id);
+    }
+    jobs[id].active = false;
+    portEXIT_CRITICAL(&mux);
+}
+
+// 주기 작업만 - 지금부터 새 간격으로 다시 예약하고 NVS에 저장해 재부팅 후에도 유지
+bool Scheduler::setInterval(const char* name, uint32_t periodMs) {
+    if (periodMs < SCHED_TICK_MS) {
+        return false;
+    }
+
+    portENTER_CRITICAL(&mux);
+    int8_t id = find(name);
+    bool ok = id >= 0 && jobs[id].periodMs > 0;
+    if (ok) {
+        jobs[id].periodMs = periodMs;
+        if (jobs[id].queued) {
+            arm(id, periodMs);
+        }
+    }
+    portEXIT_CRITICAL(&mux);
+
+    if (!ok) {
+        return false;
+    }
+
+    preferences.begin("sched", false);
+    preferences.putUInt(jobs[id].name, periodMs);
+    preferences.end();
+    LOG_I(TAG, "Job %s interval set to %lums", jobs[id].name, (unsigned long)periodMs);
+    return true;
+}
+
+// 저장된 간격이 있으면 기본값 대신 사용 (키 = 작업 이름, NVS 키는 15자 이내)
+uint32_t Scheduler::loadInterval(const char* name, uint32_t periodMs) {
+    preferences.begin("sched", true);
+    uint32_t stored = preferences.getUInt(name, periodMs);
+    preferences.end();
+    return stored >= SCHED_TICK_MS ? stored : periodMs;
+}
+
+// mux 안에서 호출
+int8_t Scheduler::find(const char* name) {
+    for (int8_t id = 0; id < SCHED_MAX_JOBS; id++) {
+        if (jobs[id].name != nullptr && strcmp(jobs[id].name, name) == 0) {
+            return id;
+        }
+    }
+    return -1;
+}
+
+// mux 안에서 호출 - 같은 이름이면 통계를 유지한 채 재사용
+int8_t Scheduler::allocate(const char* name) {
+    int8_t id = find(name);
+    if (id >= 0) {
+        return id;
+    }
+
+    for (id = 0; id < SCHED_MAX_JOBS; id++) {
+        if (jobs[id].name == nullptr) {
+            jobs[id] = SchedulerJob();
+            jobs[id].name = name;
+            jobs[id].next = -1;
+            return id;
+        }
+    }
+    return -1;
+}
+
+void Scheduler::link(int8_t id) {
+    int8_t& head = wheel[jobs[id].due % SCHED_WHEEL_SLOTS];
+    jobs[id].next = head;
+    head = id;
+    jobs[id].queued = true;
+}
+
+void Scheduler::unlink(int8_t id) {
+    int8_t* slot = &wheel[jobs[id].due % SCHED_WHEEL_SLOTS];
+    while (*slot >= 0) {
+        if (*slot == id) {
+            *slot = jobs[id].next;
+            break;
+        }
+        slot = &jobs[*slot].next;
+    }
+    jobs[id].next = -1;
+    jobs[id].queued = false;
+}
+
+void Scheduler::arm(int8_t id, uint32_t delayMs) {
+    if (jobs[id].queued) {
+        unlink(id);
+    }
+    jobs[id].due = nowTick() + toTicks(delayMs);
+    jobs[id].active = true;
+    link(id);
+}
+
+// 지나온 칸을 돌며 만기된 작업을 꺼내 mux 밖에서 실행
+void Scheduler::tick() {
+    uint32_t now = nowTick();
+    int8_t ready[SCHED_MAX_JOBS];
+    int32_t drift[SCHED_MAX_JOBS];
+    uint8_t readyCount = 0;
+    bool radio = false;
+
+    portENTER_CRITICAL(&mux);
+    // 한 바퀴 이상 밀렸으면 모든 칸을 한 번씩만 확인
+    uint32_t steps = now - currentTick;
+    if (steps > SCHED_WHEEL_SLOTS) {
+        steps = SCHED_WHEEL_SLOTS;
+    }
+    for (uint32_t i = 1; i <= steps; i++) {
+        int8_t id = wheel[(currentTick + i) % SCHED_WHEEL_SLOTS];
+        while (id >= 0) {
+            int8_t next = jobs[id].next;
+            if ((int32_t)(jobs[id].due - now) <= 0) {
+                drift[readyCount] = (int32_t)(now - jobs[id].due) * SCHED_TICK_MS;
+                ready[readyCount++] = id;
+                radio |= jobs[id].coalesce;
+                unlink(id);
+            }
+            id = next;
+        }
+    }
+    currentTick = now;
+
+    // 라디오를 쓰는 작업이 깨면 곧 예정된 라디오 작업도 지금 함께 (업로드가 한 번에 몰려 나감)
+    if (radio) {
+        for (int8_t id = 0; id < SCHED_MAX_JOBS; id++) {
+            SchedulerJob& job = jobs[id];
+            if (job.queued && job.coalesce && (job.due - now) * SCHED_TICK_MS <= SCHED_COALESCE_MS) {
+                drift[readyCount] = -(int32_t)((job.due - now) * SCHED_TICK_MS);
+                ready[readyCount++] = id;
+                job.coalesced++;
+                unlink(id);
+            }
+        }
+    }
+    portEXIT_CRITICAL(&mux);
+
+    for (uint8_t i = 0; i < readyCount; i++) {
+        SchedulerJob& job = jobs[ready[i]];
+        job.lastDriftMs = drift[i];
+        if (drift[i] > job.maxDriftMs) {
+            job.maxDriftMs = drift[i];
+        }
+
+        int64_t start = esp_timer_get_time();
+        job.callback();
+        finish(ready[i], (uint32_t)(esp_timer_get_time() - start));
+    }
+}
+
+// 실행 기록 후 주기 작업은 원래 박자(이전 예정 + 주기)로 다시 예약
+void Scheduler::finish(int8_t id, uint32_t runUs) {
+    SchedulerJob& job = jobs[id];
+    uint32_t skippedPeriods = 0;
+
+    portENTER_CRITICAL(&mux);
+    job.runs++;
+    job.lastRunUs = runUs;
+    if (runUs > job.maxRunUs) {
+        job.maxRunUs = runUs;
+    }
+    if (runUs > SCHED_TICK_MS * 1000) {
+        job.overruns++;
+    }
+
+    // 콜백 안에서 다시 예약했거나 취소된 작업은 그대로 둠
+    if (!job.queued && job.active) {
+        if (job.periodMs > 0) {
+            uint32_t now = nowTick();
+            uint32_t period = toTicks(job.periodMs);
+            job.due += period;
+            if ((int32_t)(job.due - now) <= 0) {
+                // 밀린 주기를 몰아서 실행하지 않고 건너뜀
+                skippedPeriods = (now - job.due) / period + 1;
+                job.due += skippedPeriods * period;
+                job.skipped += skippedPeriods;
+            }
+            link(id);
+        } else {
+            job.active = false;
+        }
+    }
+    portEXIT_CRITICAL(&mux);
+
+    if (skippedPeriods > 0) {
+        LOG_W(TAG, "⚠️ Job %s skipped %lu period(s)", job.name, (unsigned long)skippedPeriods);
+    }
+}
+
+void Scheduler::getStats(JsonObject obj) {
+    SchedulerJob snapshot[SCHED_MAX_JOBS];
+    portENTER_CRITICAL(&mux);
+    memcpy(snapshot, jobs, sizeof(snapshot));
+    portEXIT_CRITICAL(&mux);
+    uint32_t now = nowTick();
+
+    obj["tickMs"] = SCHED_TICK_MS;
+    obj["slots"] = SCHED_WHEEL_SLOTS;
+    obj["coalesceMs"] = SCHED_COALESCE_MS;
+
+    JsonArray list = obj["jobs"].to<JsonArray>();
+    for (int i = 0; i < SCHED_MAX_JOBS; i++) {
+        const SchedulerJob& job = snapshot[i];
+        if (job.name == nullptr) {
+            continue;
+        }
+
+        JsonObject item = list.add<JsonObject>();
+        item["name"] = job.name;
+        item["periodMs"] = job.periodMs;  // 0 = 한 번만
+        item["active"] = job.active;
+        if (job.queued) {
+            item["nextInMs"] = (int32_t)(job.due - now) * SCHED_TICK_MS;
+        }
+        item["coalesce"] = job.coalesce;
+        item["runs"] = job.runs;
+        item["coalesced"] = job.coalesced;
+        item["skipped"] = job.skipped;
+        item["overruns"] = job.overruns;
+        item["lastDriftMs"] = job.lastDriftMs;
+        item["maxDriftMs"] = job.maxDriftMs;
+        item["lastRunUs"] = job.lastRunUs;
+        item["maxRunUs"] = job.maxRunUs;
+    }
+}
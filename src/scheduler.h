@@ -0,0 +1,60 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <Preferences.h>
+#include "config.h"
+
+typedef void (*SchedulerCallback)();
+
+// 작업 하나 - periodMs 0 이면 한 번만 실행
+struct SchedulerJob {
+    const char* name;
+    SchedulerCallback callback;
+    uint32_t periodMs;
+    uint32_t due;            // 실행 예정 틱 (millis() / SCHED_TICK_MS)
+    int8_t next;             // 같은 휠 칸의 다음 작업 (-1 = 끝)
+    bool active;
+    bool queued;             // 휠에 들어 있음 (실행 중에는 false)
+    bool coalesce;           // 라디오를 쓰는 작업 - 가까운 것끼리 묶어서 실행
+    uint32_t runs;
+    uint32_t coalesced;      // 다른 작업에 묶여 예정보다 먼저 실행된 횟수
+    uint32_t skipped;        // 너무 늦어서 건너뛴 주기 수
+    uint32_t overruns;       // 실행이 한 틱보다 오래 걸린 횟수 (뒤 작업을 밀어냄)
+    int32_t lastDriftMs;     // 예정 시각 대비 늦은 시간
+    int32_t maxDriftMs;
+    uint32_t lastRunUs;
+    uint32_t maxRunUs;
+};
+
+// 흩어져 있던 millis() 간격 확인을 대신하는 타이머 휠
+// sensors 태스크가 주기마다 tick() 호출 - 작업은 그 태스크에서 실행되므로 짧게 유지
+class Scheduler {
+private:
+    static SchedulerJob jobs[SCHED_MAX_JOBS];
+    static int8_t wheel[SCHED_WHEEL_SLOTS];
+    static uint32_t currentTick;
+    static portMUX_TYPE mux;
+    static Preferences preferences;
+
+    static int8_t find(const char* name);
+    static int8_t allocate(const char* name);
+    static void link(int8_t id);
+    static void unlink(int8_t id);
+    static void arm(int8_t id, uint32_t delayMs);
+    static void finish(int8_t id, uint32_t runUs);
+    static uint32_t loadInterval(const char* name, uint32_t periodMs);
+
+public:
+    static void init();
+    static int8_t every(const char* name, uint32_t periodMs, SchedulerCallback callback,
+                        uint32_t firstDelayMs, bool coalesce = false);
+    static int8_t after(const char* name, uint32_t delayMs, SchedulerCallback callback, bool coalesce = false);
+    static void cancel(int8_t id);
+    static bool setInterval(const char* name, uint32_t periodMs);
+    static void tick();
+    static void getStats(JsonObject obj);
+};
+
+#endif // SCHEDULER_H
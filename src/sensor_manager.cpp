@@ -1,30 +1,54 @@
 #include "sensor_manager.h"
+#include "temp_history.h"
+#include "anomaly_detector.h"
+#include "metrics.h"
+#include "status_store.h"
+#include "scheduler.h"
+
+static constexpr char TAG[] = "sensor";
+
+static const uint32_t READ_BUCKETS_US[] = {1000, 2500, 5000, 10000, 25000, 50000, 100000};
+static MetricHistogram readDuration("peteye_sensor_read_duration_us", "Time to read all pending DS18B20 probes",
+                                    READ_BUCKETS_US, sizeof(READ_BUCKETS_US) / sizeof(READ_BUCKETS_US[0]));
+
+static_assert(MAX_TEMP_PROBES <= 8, "pendingProbes is an 8-bit mask");
 
 OneWire SensorManager::oneWire(TEMP_SENSOR_PIN);
 DallasTemperature SensorManager::tempSensor(&oneWire);
+TempConversionState SensorManager::tempState = TEMP_IDLE;
+unsigned long SensorManager::stateDeadline = 0;
+uint16_t SensorManager::conversionWait = 750;
+uint16_t SensorManager::retryWait = 750;
+uint8_t SensorManager::tempRetries = 0;
+bool SensorManager::parasitePower = false;
+TempProbe SensorManager::probes[MAX_TEMP_PROBES];
+uint8_t SensorManager::probeCount = 0;
+uint8_t SensorManager::pendingProbes = 0;
+SemaphoreHandle_t SensorManager::busMutex = nullptr;
 
 void SensorManager::init() {
+    busMutex = xSemaphoreCreateMutex();
+    
     if (ENABLE_TEMPERATURE) {
-        DebugSystem::log("========== Temperature Sensor Debug ==========");
-        DebugSystem::log("Initializing DS18B20 on GPIO " + String(TEMP_SENSOR_PIN));
+        LOG_D(TAG, "========== Temperature Sensor Debug ==========");
+        LOG_I(TAG, "Initializing DS18B20 on GPIO %d", TEMP_SENSOR_PIN);
         
         // GPIO 상태 체크
         pinMode(TEMP_SENSOR_PIN, INPUT_PULLUP);
         delay(10);
-        int pinState = digitalRead(TEMP_SENSOR_PIN);
-        DebugSystem::log("Pin initial state (with pullup): " + String(pinState ? "HIGH" : "LOW"));
+        LOG_D(TAG, "Pin initial state (with pullup): %s", digitalRead(TEMP_SENSOR_PIN) ? "HIGH" : "LOW");
         
         // OneWire 버스 리셋 테스트
-        DebugSystem::log("Testing OneWire bus reset...");
+        LOG_D(TAG, "Testing OneWire bus reset...");
         uint8_t resetResult = oneWire.reset();
         if (resetResult) {
-            DebugSystem::log("✅ OneWire device detected (reset successful)");
+            LOG_D(TAG, "✅ OneWire device detected (reset successful)");
         } else {
-            DebugSystem::log("❌ No OneWire device found (reset failed)");
+            LOG_E(TAG, "❌ No OneWire device found (reset failed)");
         }
         
         // OneWire 장치 검색
-        DebugSystem::log("Searching for OneWire devices...");
+        LOG_D(TAG, "Searching for OneWire devices...");
         uint8_t address[8];
         int deviceCount = 0;
         
@@ -33,90 +57,83 @@ void SensorManager::init() {
         
         while (oneWire.search(address)) {
             deviceCount++;
-            String addressStr = "Device " + String(deviceCount) + " found at: ";
-            for (uint8_t i = 0; i < 8; i++) {
-                if (address[i] < 16) addressStr += "0";
-                addressStr += String(address[i], HEX);
-                if (i < 7) addressStr += ":";
-            }
-            DebugSystem::log(addressStr);
+            LOG_D(TAG, "Device %d found at: %02x:%02x:%02x:%02x:%02x:%02x:%02x:%02x", deviceCount,
+                  address[0], address[1], address[2], address[3], address[4], address[5], address[6], address[7]);
             
             // ROM 코드 검증
             if (OneWire::crc8(address, 7) != address[7]) {
-                DebugSystem::log("  ⚠️ CRC is not valid!");
+                LOG_W(TAG, "  ⚠️ CRC is not valid!");
             } else {
-                DebugSystem::log("  ✅ CRC valid");
+                LOG_D(TAG, "  ✅ CRC valid");
             }
             
             // 장치 타입 확인
             switch (address[0]) {
                 case 0x10:
-                    DebugSystem::log("  Type: DS18S20 or DS1820");
+                    LOG_D(TAG, "  Type: DS18S20 or DS1820");
                     break;
                 case 0x28:
-                    DebugSystem::log("  Type: DS18B20");
+                    LOG_D(TAG, "  Type: DS18B20");
                     break;
                 case 0x22:
-                    DebugSystem::log("  Type: DS1822");
+                    LOG_D(TAG, "  Type: DS1822");
                     break;
                 default:
-                    DebugSystem::log("  Type: Unknown (0x" + String(address[0], HEX) + ")");
+                    LOG_D(TAG, "  Type: Unknown (0x%x)", address[0]);
             }
         }
         
-        DebugSystem::log("Total OneWire devices found: " + String(deviceCount));
+        LOG_I(TAG, "Total OneWire devices found: %d", deviceCount);
         
         // DallasTemperature 라이브러리 초기화
         tempSensor.begin();
         int dallasSensorCount = tempSensor.getDeviceCount();
-        DebugSystem::log("DallasTemperature device count: " + String(dallasSensorCount));
+        LOG_D(TAG, "DallasTemperature device count: %d", dallasSensorCount);
         
         if (dallasSensorCount > 0) {
-            sysStatus.tempSensorFound = true;
+            StatusStore::setTempSensorFound(true);
             
-            // 각 센서의 해상도 설정 및 정보 출력
-            for (int i = 0; i < dallasSensorCount; i++) {
-                DeviceAddress deviceAddress;
-                if (tempSensor.getAddress(deviceAddress, i)) {
-                    tempSensor.setResolution(deviceAddress, 12);
-                    int resolution = tempSensor.getResolution(deviceAddress);
-                    DebugSystem::log("Sensor " + String(i) + " resolution set to: " + String(resolution) + " bits");
+            // 각 센서의 ROM 주소 보관, 해상도 설정 및 정보 출력
+            // 이후에는 주소 지정 읽기만 하므로 버스 검색을 반복하지 않음
+            probeCount = 0;
+            for (int i = 0; i < dallasSensorCount && probeCount < MAX_TEMP_PROBES; i++) {
+                TempProbe& probe = probes[probeCount];
+                if (tempSensor.getAddress(probe.address, i)) {
+                    tempSensor.setResolution(probe.address, TEMP_RESOLUTION);
+                    LOG_D(TAG, "Sensor %d resolution set to: %d bits", i, tempSensor.getResolution(probe.address));
                     
-                    // 파라사이트 전원 모드 체크
-                    bool parasitic = tempSensor.isParasitePowerMode();
-                    DebugSystem::log("Parasite power mode: " + String(parasitic ? "YES" : "NO"));
+                    probe.lastTemp = NAN;
+                    probe.lastLoggedTemp = 0;
+                    probe.valid = false;
+                    probe.sampleHead = 0;
+                    probe.sampleCount = 0;
+                    probeCount++;
                 }
             }
+            if (dallasSensorCount > MAX_TEMP_PROBES) {
+                LOG_W(TAG, "⚠️ Only the first %d probes are used", MAX_TEMP_PROBES);
+            }
+            StatusStore::resetProbes(probeCount);
             
-            // 첫 번째 온도 읽기 시도 (여러 번 시도)
-            DebugSystem::log("Attempting first temperature reading...");
-            float tempC = DEVICE_DISCONNECTED_C;
+            // 파라사이트 전원 모드 체크 (이 모드에서는 변환 완료 비트를 읽을 수 없음)
+            parasitePower = tempSensor.isParasitePowerMode();
+            LOG_D(TAG, "Parasite power mode: %s", parasitePower ? "YES" : "NO");
             
-            for (int attempt = 0; attempt < 3; attempt++) {
-                tempSensor.requestTemperatures();
-                delay(750); // 12비트 해상도에서 필요한 변환 시간
-                
-                tempC = tempSensor.getTempCByIndex(0);
-                if (tempC != DEVICE_DISCONNECTED_C && tempC != 85.0) {
-                    DebugSystem::log("✅ First reading successful: " + String(tempC, 2) + "°C");
-                    sysStatus.currentTemp = tempC;
-                    break;
-                } else {
-                    DebugSystem::log("Attempt " + String(attempt + 1) + " failed, retrying...");
-                    delay(500);
-                }
-            }
+            // 비동기 변환 모드 - requestTemperatures()가 즉시 반환됨
+            tempSensor.setWaitForConversion(false);
+            conversionWait = tempSensor.millisToWaitForConversion(TEMP_RESOLUTION);
             
-            if (tempC == DEVICE_DISCONNECTED_C || tempC == 85.0) {
-                DebugSystem::log("⚠️ Initial reading unstable, will retry later");
-            }
+            // 첫 번째 온도 읽기는 바로, 이후 TEMP_READ_INTERVAL 마다 스케줄러가 시작
+            LOG_D(TAG, "First temperature reading scheduled (%ums conversion)", conversionWait);
+            tempState = TEMP_IDLE;
+            Scheduler::every("temp_read", TEMP_READ_INTERVAL, requestReading, 0);
             
         } else {
-            sysStatus.tempSensorFound = false;
-            DebugSystem::log("❌ No DS18B20 temperature sensor found");
+            StatusStore::setTempSensorFound(false);
+            LOG_E(TAG, "❌ No DS18B20 temperature sensor found");
             
             // 추가 디버깅: 핀 토글 테스트
-            DebugSystem::log("Performing pin toggle test...");
+            LOG_D(TAG, "Performing pin toggle test...");
             pinMode(TEMP_SENSOR_PIN, OUTPUT);
             for (int i = 0; i < 5; i++) {
                 digitalWrite(TEMP_SENSOR_PIN, LOW);
@@ -128,86 +145,203 @@ void SensorManager::init() {
             delay(10);
             
             // 전압 레벨 체크 (아날로그 읽기 가능한 경우)
-            DebugSystem::log("Final pin state: " + String(digitalRead(TEMP_SENSOR_PIN) ? "HIGH" : "LOW"));
+            LOG_D(TAG, "Final pin state: %s", digitalRead(TEMP_SENSOR_PIN) ? "HIGH" : "LOW");
         }
         
-        DebugSystem::log("========== End Temperature Sensor Debug ==========");
+        LOG_D(TAG, "========== End Temperature Sensor Debug ==========");
     }
     
     if (ENABLE_MPU6050) {
         // TODO: MPU6050 초기화
-        DebugSystem::log("MPU6050 not yet implemented");
+        LOG_I(TAG, "MPU6050 not yet implemented");
     }
 }
 
 void SensorManager::update() {
-    // 온도 센서 업데이트
-    if (ENABLE_TEMPERATURE && sysStatus.tempSensorFound) {
-        if (millis() - sysStatus.lastTempRead > TEMP_READ_INTERVAL) {
-            float temp = readTemperature();
-            if (temp != DEVICE_DISCONNECTED_C) {
-                sysStatus.currentTemp = temp;
-                sysStatus.lastTempRead = millis();
-                
-                // 온도 변화가 1도 이상일 때만 로그
-                static float lastLoggedTemp = 0;
-                if (abs(temp - lastLoggedTemp) > 1.0) {
-                    DebugSystem::log("Temperature: " + String(temp, 1) + "°C");
-                    lastLoggedTemp = temp;
-                }
-            } else {
-                // 읽기 실패 시 상세 로그
-                static unsigned long lastErrorLog = 0;
-                if (millis() - lastErrorLog > 10000) { // 10초마다 에러 로그
-                    DebugSystem::log("⚠️ Temperature read failed - checking connection...");
-                    
-                    // 연결 재확인
-                    uint8_t resetResult = oneWire.reset();
-                    if (!resetResult) {
-                        DebugSystem::log("❌ OneWire connection lost!");
-                        sysStatus.tempSensorFound = false;
-                    }
-                    lastErrorLog = millis();
-                }
+    // 온도 센서 업데이트 - 각 단계는 즉시 반환 (delay 없음)
+    if (!ENABLE_TEMPERATURE || !StatusStore::tempSensorFound()) {
+        return;
+    }
+    
+    unsigned long now = millis();
+    switch (tempState) {
+        case TEMP_CONVERTING:
+            // 파라사이트 모드에서는 데드라인까지 기다림
+            if ((!parasitePower && tempSensor.isConversionComplete()) ||
+                (long)(now - stateDeadline) >= 0) {
+                finishConversion();
             }
-        }
+            break;
+            
+        case TEMP_IDLE:
+        case TEMP_RETRY_WAIT:
+            break;  // 스케줄러 작업(temp_read / temp_retry)이 다음 변환을 시작
     }
 }
 
-float SensorManager::readTemperature() {
-    if (!sysStatus.tempSensorFound) {
-        return DEVICE_DISCONNECTED_C;
+// 읽기 주기 작업 - 이전 읽기가 아직 진행 중이거나 진단 작업이 버스를 쓰고 있으면 이번 주기는 건너뜀
+void SensorManager::requestReading() {
+    if (tempState != TEMP_IDLE || !lockBus(0)) {
+        return;
     }
-    
-    // 온도 변환 요청
+    tempRetries = 0;
+    pendingProbes = (1 << probeCount) - 1;
+    startConversion(conversionWait);
+}
+
+void SensorManager::retryConversion() {
+    if (tempState == TEMP_RETRY_WAIT) {
+        startConversion(retryWait);
+    }
+}
+
+// 버스를 오래 쓰는 작업(진단)은 작업 태스크에서 이걸로 읽기 주기와 겹치지 않게 함
+bool SensorManager::lockBus(TickType_t wait) {
+    return busMutex == nullptr || xSemaphoreTake(busMutex, wait) == pdTRUE;
+}
+
+void SensorManager::unlockBus() {
+    if (busMutex != nullptr) {
+        xSemaphoreGive(busMutex);
+    }
+}
+
+void SensorManager::startConversion(uint16_t waitMs) {
+    // 버스 전체 변환 요청 (Skip ROM, 비동기 - 바로 반환)
     tempSensor.requestTemperatures();
+    stateDeadline = millis() + waitMs;
+    tempState = TEMP_CONVERTING;
+}
+
+void SensorManager::finishConversion() {
+    bool got85 = false;
+    int64_t readStart = esp_timer_get_time();
     
-    // 충분한 변환 시간 대기 (12비트 = 750ms)
-    delay(750);  // 중요! 이 지연이 필요합니다
+    // 보관된 주소로 프로브별 읽기 - 이미 읽은 프로브는 건너뜀
+    for (uint8_t i = 0; i < probeCount; i++) {
+        if (!(pendingProbes & (1 << i))) {
+            continue;
+        }
+        
+        float temp = tempSensor.getTempC(probes[i].address);
+        if (temp == 85.0 || temp == DEVICE_DISCONNECTED_C) {
+            got85 |= (temp == 85.0);
+            continue;
+        }
+        
+        recordSample(i, temp);
+        pendingProbes &= ~(1 << i);
+    }
+    readDuration.observeSince(readStart);
     
-    // 온도 읽기
-    float temp = tempSensor.getTempCByIndex(0);
+    // 비정상적인 값은 상태 머신 안에서 재시도 (실패한 프로브만 다시 읽음)
+    if (pendingProbes != 0) {
+        if (tempRetries < TEMP_MAX_RETRIES) {
+            tempRetries++;
+            if (got85) {
+                LOG_W(TAG, "⚠️ Got 85°C - possible power reset or connection issue");
+                retryWait = conversionWait;
+            } else {
+                LOG_W(TAG, "⚠️ Got -127°C - retrying with longer delay...");
+                retryWait = TEMP_RETRY_LONG_WAIT;  // 더 긴 대기
+            }
+            tempState = TEMP_RETRY_WAIT;
+            Scheduler::after("temp_retry", TEMP_RETRY_DELAY, retryConversion);
+            return;
+        }
+        
+        for (uint8_t i = 0; i < probeCount; i++) {
+            if (pendingProbes & (1 << i)) {
+                probes[i].valid = false;
+                StatusStore::setProbeTemp(i, NAN);
+            }
+        }
+    }
     
-    // 디버깅: 비정상적인 값 체크
-    if (temp == 85.0) {
-        DebugSystem::log("⚠️ Got 85°C - possible power reset or connection issue");
-        // 재시도
-        delay(100);
-        tempSensor.requestTemperatures();
-        delay(750);
-        temp = tempSensor.getTempCByIndex(0);
-    } else if (temp == -127.0) {
-        DebugSystem::log("⚠️ Got -127°C - retrying with longer delay...");
-        // 더 긴 지연으로 재시도
-        delay(100);
-        tempSensor.requestTemperatures();
-        delay(1000);  // 더 긴 대기
-        temp = tempSensor.getTempCByIndex(0);
+    tempState = TEMP_IDLE;
+    unlockBus();
+    updatePrimaryTemp();
+    
+    if (pendingProbes == (1 << probeCount) - 1) {
+        handleReadFailure();
+    }
+}
+
+void SensorManager::recordSample(uint8_t index, float temp) {
+    TempProbe& probe = probes[index];
+    probe.lastTemp = temp;
+    probe.valid = true;
+    probe.samples[probe.sampleHead] = temp;
+    probe.sampleHead = (probe.sampleHead + 1) % TEMP_PROBE_RING_SIZE;
+    if (probe.sampleCount < TEMP_PROBE_RING_SIZE) {
+        probe.sampleCount++;
     }
+    StatusStore::setProbeTemp(index, temp);
     
-    return temp;
+    // 온도 변화가 1도 이상일 때만 로그
+    if (abs(temp - probe.lastLoggedTemp) > 1.0) {
+        LOG_I(TAG, "Temperature[%u]: %.1f°C", index, temp);
+        probe.lastLoggedTemp = temp;
+    }
+}
+
+void SensorManager::updatePrimaryTemp() {
+    // 대표 온도는 첫 번째 정상 프로브 값
+    for (uint8_t i = 0; i < probeCount; i++) {
+        if (probes[i].valid) {
+            unsigned long now = millis();
+            StatusStore::setTemperature(probes[i].lastTemp, now);
+            TempHistory::record(probes[i].lastTemp, now / 1000);
+            AnomalyDetector::update(probes[i].lastTemp, now);
+            return;
+        }
+    }
+}
+
+void SensorManager::handleReadFailure() {
+    // 읽기 실패 시 상세 로그
+    static unsigned long lastErrorLog = 0;
+    if (millis() - lastErrorLog > 10000) { // 10초마다 에러 로그
+        LOG_W(TAG, "⚠️ Temperature read failed - checking connection...");
+        
+        // 연결 재확인
+        uint8_t resetResult = oneWire.reset();
+        if (!resetResult) {
+            LOG_E(TAG, "❌ OneWire connection lost!");
+            StatusStore::setTempSensorFound(false);
+        }
+        lastErrorLog = millis();
+    }
 }
 
 bool SensorManager::isTemperatureSensorConnected() {
-    return sysStatus.tempSensorFound;
-}
\ No newline at end of file
+    return StatusStore::tempSensorFound();
+}
+
+uint8_t SensorManager::getProbeCount() {
+    return probeCount;
+}
+
+const TempProbe* SensorManager::getProbe(uint8_t index) {
+    return index < probeCount ? &probes[index] : nullptr;
+}
+
+float SensorManager::getProbeAverage(uint8_t index) {
+    if (index >= probeCount || probes[index].sampleCount == 0) {
+        return NAN;
+    }
+    
+    const TempProbe& probe = probes[index];
+    float sum = 0;
+    for (uint8_t i = 0; i < probe.sampleCount; i++) {
+        sum += probe.samples[i];
+    }
+    return sum / probe.sampleCount;
+}
+
+void SensorManager::formatAddress(const uint8_t* address, char* out) {
+    // out은 최소 17바이트 (16진수 16자 + NUL)
+    for (uint8_t i = 0; i < 8; i++) {
+        sprintf(out + i * 2, "%02x", address[i]);
+    }
+}
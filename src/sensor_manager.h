@@ -3,19 +3,62 @@
 
 #include <OneWire.h>
 #include <DallasTemperature.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 #include "config.h"
 #include "debug_system.h"
 
+// 버스에 연결된 DS18B20 하나 - ROM 주소는 init()에서 한 번만 검색해 보관
+struct TempProbe {
+    DeviceAddress address;
+    float lastTemp;
+    float lastLoggedTemp;
+    bool valid;
+    float samples[TEMP_PROBE_RING_SIZE];
+    uint8_t sampleHead;
+    uint8_t sampleCount;
+};
+
+// 온도 변환 상태 - update()가 블로킹 없이 한 단계씩 진행
+enum TempConversionState {
+    TEMP_IDLE,          // 다음 읽기 주기 대기
+    TEMP_CONVERTING,    // 변환 요청 후 완료/데드라인 대기
+    TEMP_RETRY_WAIT     // 85°C / -127°C 수신 후 재시도 전 대기
+};
+
 class SensorManager {
 private:
     static OneWire oneWire;
     static DallasTemperature tempSensor;
+    static TempConversionState tempState;
+    static unsigned long stateDeadline;
+    static uint16_t conversionWait;
+    static uint16_t retryWait;
+    static uint8_t tempRetries;
+    static bool parasitePower;
+    static TempProbe probes[MAX_TEMP_PROBES];
+    static uint8_t probeCount;
+    static uint8_t pendingProbes;   // 이번 주기에 아직 값을 못 읽은 프로브 비트마스크
+    static SemaphoreHandle_t busMutex;  // OneWire 버스 - 읽기 주기(변환~읽기) 동안 또는 진단 작업이 보유
+    
+    static void requestReading();
+    static void retryConversion();
+    static void startConversion(uint16_t waitMs);
+    static void finishConversion();
+    static void recordSample(uint8_t index, float temp);
+    static void updatePrimaryTemp();
+    static void handleReadFailure();
     
 public:
     static void init();
     static void update();
-    static float readTemperature();
     static bool isTemperatureSensorConnected();
+    static uint8_t getProbeCount();
+    static const TempProbe* getProbe(uint8_t index);
+    static float getProbeAverage(uint8_t index);
+    static void formatAddress(const uint8_t* address, char* out);
+    static bool lockBus(TickType_t wait);
+    static void unlockBus();
 };
 
 #endif // SENSOR_MANAGER_H
\ No newline at end of file
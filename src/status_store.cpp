@@ -0,0 +1,126 @@
+#include "status_store.h"
+
+SystemStatus StatusStore::data = {};
+std::atomic<uint32_t> StatusStore::sequence(0);
+portMUX_TYPE StatusStore::writeMux = portMUX_INITIALIZER_UNLOCKED;
+String StatusStore::deviceIdValue;
+
+void StatusStore::beginWrite() {
+    portENTER_CRITICAL(&writeMux);
+    sequence.fetch_add(1, std::memory_order_relaxed);  // 홀수 = 쓰는 중
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void StatusStore::endWrite() {
+    sequence.fetch_add(1, std::memory_order_release);
+    portEXIT_CRITICAL(&writeMux);
+}
+
+void StatusStore::read(SystemStatus& out) {
+    // 쓰기는 임계 구역 안이라 선점되지 않으므로 재시도는 짧게 끝남
+    for (;;) {
+        uint32_t before = sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            continue;
+        }
+        memcpy(&out, &data, sizeof(out));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) == before) {
+            return;
+        }
+    }
+}
+
+void StatusStore::setDeviceId(const String& id) {
+    deviceIdValue = id;
+}
+
+void StatusStore::setWiFi(bool connected, IPAddress ip) {
+    beginWrite();
+    data.wifiConnected = connected;
+    data.localIP = ip;
+    endWrite();
+}
+
+void StatusStore::setWiFiConnected(bool connected) {
+    beginWrite();
+    data.wifiConnected = connected;
+    endWrite();
+}
+
+void StatusStore::setLocalIP(IPAddress ip) {
+    beginWrite();
+    data.localIP = ip;
+    endWrite();
+}
+
+void StatusStore::setCameraInitialized(bool ready) {
+    beginWrite();
+    data.cameraInitialized = ready;
+    endWrite();
+}
+
+void StatusStore::setTempSensorFound(bool found) {
+    beginWrite();
+    data.tempSensorFound = found;
+    endWrite();
+}
+
+void StatusStore::resetProbes(uint8_t count) {
+    beginWrite();
+    data.tempProbeCount = min(count, (uint8_t)MAX_TEMP_PROBES);
+    for (int i = 0; i < MAX_TEMP_PROBES; i++) {
+        data.probeTemps[i] = NAN;
+    }
+    endWrite();
+}
+
+void StatusStore::setProbeTemp(uint8_t index, float temp) {
+    if (index >= MAX_TEMP_PROBES) {
+        return;
+    }
+    beginWrite();
+    data.probeTemps[index] = temp;
+    endWrite();
+}
+
+void StatusStore::setTemperature(float temp, unsigned long readAt) {
+    beginWrite();
+    data.currentTemp = temp;
+    data.lastTempRead = readAt;
+    endWrite();
+}
+
+const String& StatusStore::deviceId() {
+    return deviceIdValue;
+}
+
+bool StatusStore::wifiConnected() {
+    SystemStatus status;
+    read(status);
+    return status.wifiConnected;
+}
+
+bool StatusStore::cameraInitialized() {
+    SystemStatus status;
+    read(status);
+    return status.cameraInitialized;
+}
+
+bool StatusStore::tempSensorFound() {
+    SystemStatus status;
+    read(status);
+    return status.tempSensorFound;
+}
+
+float StatusStore::currentTemp() {
+    SystemStatus status;
+    read(status);
+    return status.currentTemp;
+}
+
+IPAddress StatusStore::localIP() {
+    SystemStatus status;
+    read(status);
+    return IPAddress(status.localIP);
+}
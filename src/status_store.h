@@ -0,0 +1,58 @@
+#ifndef STATUS_STORE_H
+#define STATUS_STORE_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "config.h"
+
+// 시스템 상태 한 벌 - 통째로 복사할 수 있는 값만 (String/IPAddress 없음)
+struct SystemStatus {
+    bool wifiConnected;
+    bool cameraInitialized;
+    bool tempSensorFound;
+    bool mpuConnected;
+    float currentTemp;           // 대표 온도 (첫 번째 정상 프로브)
+    uint8_t tempProbeCount;
+    float probeTemps[MAX_TEMP_PROBES];  // 프로브별 최신 온도 (실패 시 NAN)
+    unsigned long lastTempRead;
+    unsigned long lastApiUpdate;
+    uint32_t localIP;
+};
+
+// 시퀀스 락(seqlock) 상태 저장소
+// 쓰기: 짧은 임계 구역에서 시퀀스를 홀수로 올리고 필드를 바꾼 뒤 다시 짝수로 (쓰는 쪽끼리만 직렬화)
+// 읽기: 잠금 없이 복사한 뒤 시퀀스가 그대로인지 확인, 바뀌었으면 다시 복사 - 센서 경로의 쓰기를 막지 않음
+class StatusStore {
+private:
+    static SystemStatus data;
+    static std::atomic<uint32_t> sequence;
+    static portMUX_TYPE writeMux;
+    static String deviceIdValue;
+
+    static void beginWrite();
+    static void endWrite();
+
+public:
+    static void read(SystemStatus& out);
+
+    // 필드별 갱신 - 함께 바뀌는 값은 한 번에
+    static void setDeviceId(const String& id);   // 부팅 중 태스크 시작 전에 한 번만
+    static void setWiFi(bool connected, IPAddress ip);
+    static void setWiFiConnected(bool connected);
+    static void setLocalIP(IPAddress ip);
+    static void setCameraInitialized(bool ready);
+    static void setTempSensorFound(bool found);
+    static void resetProbes(uint8_t count);      // 프로브 수 설정, 온도는 모두 NAN
+    static void setProbeTemp(uint8_t index, float temp);
+    static void setTemperature(float temp, unsigned long readAt);
+
+    // 단일 필드 조회 (여러 필드를 함께 쓸 때는 read()로 한 번에)
+    static const String& deviceId();
+    static bool wifiConnected();
+    static bool cameraInitialized();
+    static bool tempSensorFound();
+    static float currentTemp();
+    static IPAddress localIP();
+};
+
+#endif // STATUS_STORE_H
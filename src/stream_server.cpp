@@ -0,0 +1,274 @@
+#include "stream_server.h"
+#include "debug_system.h"
+
+static constexpr char TAG[] = "stream";
+
+#define STREAM_BOUNDARY "peteyeframe"
+#define STREAM_HANDSHAKE_TIMEOUT 2000
+
+static const char STREAM_RESPONSE_HEADER[] =
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Type: multipart/x-mixed-replace;boundary=" STREAM_BOUNDARY "\r\n"
+    "Access-Control-Allow-Origin: *\r\n"
+    "Cache-Control: no-cache, no-store\r\n"
+    "Connection: close\r\n"
+    "\r\n";
+
+WiFiServer StreamServer::server(STREAM_SERVER_PORT);
+StreamClient StreamServer::clients[STREAM_MAX_CLIENTS];
+SemaphoreHandle_t StreamServer::clientsMutex = nullptr;
+TaskHandle_t StreamServer::captureTask = nullptr;
+uint32_t StreamServer::framesCaptured = 0;
+
+void StreamServer::init() {
+    if (captureTask != nullptr) {
+        return;
+    }
+
+    clientsMutex = xSemaphoreCreateMutex();
+    for (int i = 0; i < STREAM_MAX_CLIENTS; i++) {
+        clients[i].active = false;
+        clients[i].inUse = false;
+        clients[i].task = nullptr;
+        clients[i].queue = xQueueCreate(STREAM_CLIENT_QUEUE_LEN, sizeof(SharedFrame*));
+    }
+
+    server.begin();
+    server.setNoDelay(true);
+
+    // 캡처 태스크는 카메라와 같은 코어(1)에서, 전송 태스크는 네트워크 코어(0)에서 실행
+    xTaskCreatePinnedToCore(captureLoop, "stream_cap", 4096, nullptr, 1, &captureTask, 1);
+    LOG_I(TAG, "Stream server started on port %d", STREAM_SERVER_PORT);
+}
+
+bool StreamServer::isRunning() {
+    return captureTask != nullptr;
+}
+
+int StreamServer::clientCount() {
+    int count = 0;
+    for (int i = 0; i < STREAM_MAX_CLIENTS; i++) {
+        if (clients[i].active) {
+            count++;
+        }
+    }
+    return count;
+}
+
+void StreamServer::captureLoop(void* param) {
+    TickType_t lastWake = xTaskGetTickCount();
+
+    for (;;) {
+        acceptClients();
+
+        // 시청자가 있을 때만 캡처 - 틱마다 한 번만 캡처해서 모두에게 공유
+        if (clientCount() > 0 && CameraManager::isInitialized()) {
+            SharedFrame* frame = CameraManager::captureShared();
+            if (frame) {
+                framesCaptured++;
+                fanOut(frame);
+                CameraManager::releaseShared(frame);
+            }
+        }
+
+        vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(STREAM_FRAME_INTERVAL));
+    }
+}
+
+void StreamServer::acceptClients() {
+    WiFiClient incoming = server.available();
+    if (!incoming) {
+        return;
+    }
+
+    StreamClient* slot = nullptr;
+    xSemaphoreTake(clientsMutex, portMAX_DELAY);
+    for (int i = 0; i < STREAM_MAX_CLIENTS; i++) {
+        if (!clients[i].inUse) {
+            slot = &clients[i];
+            slot->inUse = true;
+            slot->active = false;
+            break;
+        }
+    }
+    xSemaphoreGive(clientsMutex);
+
+    if (slot == nullptr) {
+        LOG_W(TAG, "⚠️ Stream client rejected - max %d viewers", STREAM_MAX_CLIENTS);
+        incoming.print("HTTP/1.1 503 Service Unavailable\r\nConnection: close\r\n\r\n");
+        incoming.stop();
+        return;
+    }
+
+    slot->client = incoming;
+    slot->client.setNoDelay(true);
+    slot->ip = incoming.remoteIP();
+    slot->connectedAt = millis();
+    slot->framesSent = 0;
+    slot->framesDropped = 0;
+    slot->windowFrames = 0;
+    slot->windowStart = millis();
+    slot->fps = 0;
+
+    if (xTaskCreatePinnedToCore(clientLoop, "stream_cli", 4096, slot, 1, &slot->task, 0) != pdPASS) {
+        LOG_E(TAG, "❌ Failed to start stream client task");
+        closeClient(slot);
+    }
+}
+
+void StreamServer::fanOut(SharedFrame* frame) {
+    xSemaphoreTake(clientsMutex, portMAX_DELAY);
+    for (int i = 0; i < STREAM_MAX_CLIENTS; i++) {
+        StreamClient* slot = &clients[i];
+        if (!slot->active) {
+            continue;
+        }
+
+        // 큐가 가득 차면 가장 오래된 프레임을 버림 (느린 시청자만 손해)
+        if (uxQueueSpacesAvailable(slot->queue) == 0) {
+            SharedFrame* stale = nullptr;
+            if (xQueueReceive(slot->queue, &stale, 0) == pdTRUE) {
+                CameraManager::releaseShared(stale);
+                slot->framesDropped++;
+            }
+        }
+
+        CameraManager::retainShared(frame);
+        if (xQueueSend(slot->queue, &frame, 0) != pdTRUE) {
+            CameraManager::releaseShared(frame);
+            slot->framesDropped++;
+        }
+    }
+    xSemaphoreGive(clientsMutex);
+}
+
+bool StreamServer::handshake(StreamClient* slot) {
+    // 요청 헤더 끝(\r\n\r\n)까지 읽고 첫 줄만 보관
+    char requestLine[64] = {0};
+    size_t lineLen = 0;
+    bool lineDone = false;
+    uint32_t tail = 0;
+    unsigned long deadline = millis() + STREAM_HANDSHAKE_TIMEOUT;
+
+    while (tail != 0x0D0A0D0A) {
+        if ((long)(millis() - deadline) > 0 || !slot->client.connected()) {
+            return false;
+        }
+        if (!slot->client.available()) {
+            vTaskDelay(pdMS_TO_TICKS(5));
+            continue;
+        }
+
+        char c = slot->client.read();
+        tail = (tail << 8) | (uint8_t)c;
+        if (!lineDone) {
+            if (c == '\r' || c == '\n') {
+                lineDone = true;
+            } else if (lineLen < sizeof(requestLine) - 1) {
+                requestLine[lineLen++] = c;
+            }
+        }
+    }
+
+    if (strncmp(requestLine, "GET /stream", 11) != 0) {
+        slot->client.print("HTTP/1.1 404 Not Found\r\nConnection: close\r\n\r\n");
+        return false;
+    }
+
+    size_t headerLen = sizeof(STREAM_RESPONSE_HEADER) - 1;
+    return slot->client.write((const uint8_t*)STREAM_RESPONSE_HEADER, headerLen) == headerLen;
+}
+
+void StreamServer::clientLoop(void* param) {
+    StreamClient* slot = (StreamClient*)param;
+
+    if (handshake(slot)) {
+        slot->active = true;
+        LOG_I(TAG, "📺 Stream client connected: %u.%u.%u.%u (%d viewers)",
+              slot->ip[0], slot->ip[1], slot->ip[2], slot->ip[3], clientCount());
+
+        char partHeader[96];
+        for (;;) {
+            SharedFrame* frame = nullptr;
+            if (xQueueReceive(slot->queue, &frame, pdMS_TO_TICKS(1000)) != pdTRUE) {
+                if (!slot->client.connected()) {
+                    break;
+                }
+                continue;
+            }
+
+            int headerLen = snprintf(partHeader, sizeof(partHeader),
+                                     "--" STREAM_BOUNDARY "\r\nContent-Type: image/jpeg\r\nContent-Length: %u\r\n\r\n",
+                                     (unsigned)frame->len);
+            bool ok = slot->client.write((const uint8_t*)partHeader, headerLen) == (size_t)headerLen &&
+                      slot->client.write(frame->buf, frame->len) == frame->len &&
+                      slot->client.write((const uint8_t*)"\r\n", 2) == 2;
+            CameraManager::releaseShared(frame);
+
+            if (!ok) {
+                break;
+            }
+
+            slot->framesSent++;
+            slot->windowFrames++;
+            unsigned long elapsed = millis() - slot->windowStart;
+            if (elapsed >= STREAM_STATS_WINDOW) {
+                slot->fps = slot->windowFrames * 1000.0f / elapsed;
+                slot->windowFrames = 0;
+                slot->windowStart = millis();
+            }
+        }
+
+        LOG_I(TAG, "📺 Stream client disconnected: %u.%u.%u.%u - sent %u, dropped %u",
+              slot->ip[0], slot->ip[1], slot->ip[2], slot->ip[3],
+              slot->framesSent, slot->framesDropped);
+    }
+
+    closeClient(slot);
+    vTaskDelete(NULL);
+}
+
+void StreamServer::closeClient(StreamClient* slot) {
+    xSemaphoreTake(clientsMutex, portMAX_DELAY);
+    slot->active = false;
+
+    SharedFrame* frame = nullptr;
+    while (xQueueReceive(slot->queue, &frame, 0) == pdTRUE) {
+        CameraManager::releaseShared(frame);
+    }
+
+    slot->client.stop();
+    slot->task = nullptr;
+    slot->inUse = false;
+    xSemaphoreGive(clientsMutex);
+}
+
+void StreamServer::getStats(JsonObject obj) {
+    obj["running"] = isRunning();
+    obj["framesCaptured"] = framesCaptured;
+    obj["maxClients"] = STREAM_MAX_CLIENTS;
+
+    JsonArray viewers = obj["viewers"].to<JsonArray>();
+    if (!isRunning()) {
+        obj["clients"] = 0;
+        return;
+    }
+
+    xSemaphoreTake(clientsMutex, portMAX_DELAY);
+    for (int i = 0; i < STREAM_MAX_CLIENTS; i++) {
+        StreamClient* slot = &clients[i];
+        if (!slot->active) {
+            continue;
+        }
+
+        JsonObject viewer = viewers.add<JsonObject>();
+        viewer["ip"] = slot->ip.toString();
+        viewer["fps"] = slot->fps;
+        viewer["framesSent"] = slot->framesSent;
+        viewer["framesDropped"] = slot->framesDropped;
+        viewer["queued"] = uxQueueMessagesWaiting(slot->queue);
+        viewer["connectedSec"] = (millis() - slot->connectedAt) / 1000;
+    }
+    xSemaphoreGive(clientsMutex);
+    obj["clients"] = viewers.size();
+}
@@ -0,0 +1,54 @@
+#ifndef STREAM_SERVER_H
+#define STREAM_SERVER_H
+
+#include <WiFi.h>
+#include <ArduinoJson.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "config.h"
+#include "camera_manager.h"
+
+// 시청자 한 명의 연결 상태
+struct StreamClient {
+    volatile bool active;      // 핸드셰이크 완료, 프레임 수신 중
+    volatile bool inUse;       // 슬롯 점유 (핸드셰이크/종료 포함)
+    WiFiClient client;
+    QueueHandle_t queue;       // SharedFrame* 전송 대기열
+    TaskHandle_t task;
+    IPAddress ip;
+    unsigned long connectedAt;
+    uint32_t framesSent;
+    uint32_t framesDropped;
+    uint32_t windowFrames;
+    unsigned long windowStart;
+    float fps;
+};
+
+// 포트 STREAM_SERVER_PORT 에서 multipart/x-mixed-replace MJPEG 스트림 제공
+// 캡처 태스크가 틱마다 한 프레임을 잡아 모든 시청자 큐에 같은 버퍼를 넣고,
+// 시청자별 전송 태스크가 각자 속도로 내보냄 (느린 시청자는 자기 프레임만 버림)
+class StreamServer {
+private:
+    static WiFiServer server;
+    static StreamClient clients[STREAM_MAX_CLIENTS];
+    static SemaphoreHandle_t clientsMutex;
+    static TaskHandle_t captureTask;
+    static uint32_t framesCaptured;
+
+    static void captureLoop(void* param);
+    static void clientLoop(void* param);
+    static void acceptClients();
+    static void fanOut(SharedFrame* frame);
+    static bool handshake(StreamClient* slot);
+    static void closeClient(StreamClient* slot);
+
+public:
+    static void init();
+    static bool isRunning();
+    static int clientCount();
+    static void getStats(JsonObject obj);
+};
+
+#endif // STREAM_SERVER_H
@@ -0,0 +1,123 @@
+#include "telemetry_batcher.h"
+#include <WiFi.h>
+#include "debug_system.h"
+#include "sensor_manager.h"
+#include "upload_pipeline.h"
+#include "status_store.h"
+#include "scheduler.h"
+
+static constexpr char TAG[] = "telemetry";
+
+TelemetryReading TelemetryBatcher::readings[TELEMETRY_BATCH_SIZE];
+uint8_t TelemetryBatcher::head = 0;
+uint8_t TelemetryBatcher::count = 0;
+int8_t TelemetryBatcher::flushJob = -1;
+TelemetryStats TelemetryBatcher::stats = {};
+
+void TelemetryBatcher::addReading() {
+    // 버퍼가 가득 찬 상태(큐에 넣지 못함)면 가장 오래된 측정값을 덮어씀
+    if (count == TELEMETRY_BATCH_SIZE) {
+        head = (head + 1) % TELEMETRY_BATCH_SIZE;
+        count--;
+        stats.readingsDropped++;
+    }
+    if (count == 0) {
+        // 배치의 첫 측정값 - 최대 보관 시간 뒤에 전송 (라디오 작업끼리 묶일 수 있음)
+        flushJob = Scheduler::after("telemetry_flush", TELEMETRY_BATCH_MAX_AGE, flushDue, true);
+    }
+
+    TelemetryReading& reading = readings[(head + count) % TELEMETRY_BATCH_SIZE];
+    reading.timestamp = millis() / 1000;
+    SystemStatus status;
+    StatusStore::read(status);
+    reading.temperature = status.currentTemp;
+    reading.rssi = WiFi.RSSI();
+    reading.freeHeap = ESP.getFreeHeap();
+    reading.probeCount = status.tempProbeCount;
+    for (uint8_t i = 0; i < status.tempProbeCount; i++) {
+        reading.probeTemps[i] = status.probeTemps[i];
+    }
+
+    count++;
+    stats.readings++;
+
+    if (count >= TELEMETRY_BATCH_SIZE) {
+        flush();
+    }
+}
+
+void TelemetryBatcher::flushDue() {
+    // 큐에 넣지 못했으면 다음 수집 주기에 다시 시도
+    if (!flush() && count > 0) {
+        flushJob = Scheduler::after("telemetry_flush", TELEMETRY_SAMPLE_INTERVAL, flushDue, true);
+    }
+}
+
+bool TelemetryBatcher::flush() {
+    // 오프라인이어도 큐에 넣음 - 전송 실패분은 OfflineQueue가 보관 후 재전송
+    if (count == 0) {
+        return false;
+    }
+
+    JsonDocument doc;
+    buildDocument(doc);
+    size_t bytes = 0;
+    if (!UploadPipeline::enqueueDocument("/temperature/batch", doc, false, &bytes)) {
+        LOG_E(TAG, "❌ Telemetry batch could not be queued");
+        return false;
+    }
+
+    stats.requests++;
+    stats.readingsSent += count;
+    stats.bytesSent += bytes;
+    LOG_D(TAG, "Telemetry batch queued: %u readings, %u bytes (%s)",
+          count, (unsigned)bytes, WireCodec::name(WireCodec::uploadFormat()));
+
+    head = 0;
+    count = 0;
+    Scheduler::cancel(flushJob);
+    return true;
+}
+
+void TelemetryBatcher::buildDocument(JsonDocument& doc) {
+    doc["device_id"] = StatusStore::deviceId();
+
+    // 프로브 ID는 배치당 한 번만 보냄
+    JsonArray probeIds = doc["probe_ids"].to<JsonArray>();
+    for (uint8_t i = 0; i < SensorManager::getProbeCount(); i++) {
+        char address[17];
+        SensorManager::formatAddress(SensorManager::getProbe(i)->address, address);
+        probeIds.add(address);
+    }
+
+    JsonArray items = doc["readings"].to<JsonArray>();
+    for (uint8_t n = 0; n < count; n++) {
+        const TelemetryReading& reading = readings[(head + n) % TELEMETRY_BATCH_SIZE];
+        JsonObject item = items.add<JsonObject>();
+        item["timestamp"] = reading.timestamp;
+        item["temperature"] = reading.temperature;
+        item["rssi"] = reading.rssi;
+        item["free_heap"] = reading.freeHeap;
+
+        JsonArray probes = item["probes"].to<JsonArray>();
+        for (uint8_t i = 0; i < reading.probeCount; i++) {
+            probes.add(reading.probeTemps[i]);
+        }
+    }
+}
+
+uint8_t TelemetryBatcher::pending() {
+    return count;
+}
+
+void TelemetryBatcher::getStats(JsonObject obj) {
+    obj["pending"] = count;
+    obj["batchSize"] = TELEMETRY_BATCH_SIZE;
+    obj["readings"] = stats.readings;
+    obj["readingsSent"] = stats.readingsSent;
+    obj["readingsDropped"] = stats.readingsDropped;
+    obj["requests"] = stats.requests;
+    obj["bytesSent"] = stats.bytesSent;
+    obj["bytesPerReading"] = stats.readingsSent ? stats.bytesSent / stats.readingsSent : 0;
+    obj["readingsPerRequest"] = stats.requests ? (float)stats.readingsSent / stats.requests : 0;
+}
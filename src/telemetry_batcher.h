@@ -0,0 +1,45 @@
+#ifndef TELEMETRY_BATCHER_H
+#define TELEMETRY_BATCHER_H
+
+#include <ArduinoJson.h>
+#include "config.h"
+
+// 한 시점의 측정값 묶음
+struct TelemetryReading {
+    uint32_t timestamp;          // 부팅 후 초
+    float temperature;
+    int8_t rssi;
+    uint32_t freeHeap;
+    uint8_t probeCount;
+    float probeTemps[MAX_TEMP_PROBES];
+};
+
+struct TelemetryStats {
+    uint32_t readings;           // 수집한 측정값 수
+    uint32_t readingsSent;       // 배치로 전송 요청한 측정값 수
+    uint32_t readingsDropped;    // 배치를 큐에 넣지 못해 버퍼가 넘쳐 버린 측정값
+    uint32_t requests;           // 배치 POST 수
+    uint32_t bytesSent;
+};
+
+// 측정값을 고정 크기 버퍼에 모았다가 개수/경과 시간 기준으로 하나의 배열 페이로드로 전송
+// 측정값마다 HTTP 요청을 하던 것보다 요청 수와 라디오 사용 시간이 크게 줄어듦
+class TelemetryBatcher {
+private:
+    static TelemetryReading readings[TELEMETRY_BATCH_SIZE];
+    static uint8_t head;
+    static uint8_t count;
+    static int8_t flushJob;      // 경과 시간 기준 전송 (한 번 실행 작업)
+    static TelemetryStats stats;
+
+    static void flushDue();
+
+public:
+    static void addReading();
+    static bool flush();
+    static void buildDocument(JsonDocument& doc);
+    static uint8_t pending();
+    static void getStats(JsonObject obj);
+};
+
+#endif // TELEMETRY_BATCHER_H
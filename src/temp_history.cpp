@@ -0,0 +1,175 @@
+#include "temp_history.h"
+#include "debug_system.h"
+
+static constexpr char TAG[] = "history";
+
+TempSample* TempHistory::raw = nullptr;
+uint32_t TempHistory::rawTotal = 0;
+TempRollup* TempHistory::rollups[ROLLUP_LEVELS] = {nullptr, nullptr, nullptr};
+uint32_t TempHistory::rollupTotal[ROLLUP_LEVELS] = {0, 0, 0};
+TempRollup TempHistory::openBucket[ROLLUP_LEVELS];
+SemaphoreHandle_t TempHistory::mutex = nullptr;
+
+bool TempHistory::init() {
+    if (isReady()) {
+        return true;
+    }
+
+    if (!psramFound()) {
+        LOG_W(TAG, "⚠️ Temperature history disabled - no PSRAM");
+        return false;
+    }
+
+    raw = (TempSample*)ps_calloc(HISTORY_RAW_SAMPLES, sizeof(TempSample));
+    rollups[0] = (TempRollup*)ps_calloc(HISTORY_1M_BUCKETS, sizeof(TempRollup));
+    rollups[1] = (TempRollup*)ps_calloc(HISTORY_15M_BUCKETS, sizeof(TempRollup));
+    rollups[2] = (TempRollup*)ps_calloc(HISTORY_1H_BUCKETS, sizeof(TempRollup));
+
+    if (!raw || !rollups[0] || !rollups[1] || !rollups[2]) {
+        LOG_E(TAG, "❌ Temperature history allocation failed");
+        free(raw);
+        raw = nullptr;
+        for (uint8_t i = 0; i < ROLLUP_LEVELS; i++) {
+            free(rollups[i]);
+            rollups[i] = nullptr;
+        }
+        return false;
+    }
+
+    memset(openBucket, 0, sizeof(openBucket));
+    mutex = xSemaphoreCreateMutex();
+    LOG_I(TAG, "Temperature history ready: %u KB PSRAM", (unsigned)(memoryUsage() / 1024));
+    return true;
+}
+
+bool TempHistory::isReady() {
+    return mutex != nullptr;
+}
+
+uint32_t TempHistory::capacity(HistoryResolution res) {
+    switch (res) {
+        case HISTORY_RAW: return HISTORY_RAW_SAMPLES;
+        case HISTORY_1M:  return HISTORY_1M_BUCKETS;
+        case HISTORY_15M: return HISTORY_15M_BUCKETS;
+        case HISTORY_1H:  return HISTORY_1H_BUCKETS;
+    }
+    return 0;
+}
+
+uint32_t TempHistory::period(uint8_t level) {
+    static const uint32_t periods[ROLLUP_LEVELS] = {60, 15 * 60, 60 * 60};
+    return periods[level];
+}
+
+uint32_t TempHistory::total(HistoryResolution res) {
+    return res == HISTORY_RAW ? rawTotal : rollupTotal[res - HISTORY_1M];
+}
+
+void TempHistory::record(float value, uint32_t t) {
+    if (!isReady() || isnan(value)) {
+        return;
+    }
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+
+    raw[rawTotal % HISTORY_RAW_SAMPLES] = {t, value};
+    rawTotal++;
+
+    for (uint8_t level = 0; level < ROLLUP_LEVELS; level++) {
+        TempRollup& bucket = openBucket[level];
+        uint32_t bucketStart = t - t % period(level);
+
+        // 구간이 바뀌면 현재 구간을 링에 닫아 넣고 새 구간 시작
+        if (bucket.count > 0 && bucket.start != bucketStart) {
+            HistoryResolution res = (HistoryResolution)(HISTORY_1M + level);
+            rollups[level][rollupTotal[level] % capacity(res)] = bucket;
+            rollupTotal[level]++;
+            bucket.count = 0;
+        }
+
+        if (bucket.count == 0) {
+            bucket.start = bucketStart;
+            bucket.min = value;
+            bucket.max = value;
+            bucket.sum = 0;
+        }
+
+        bucket.min = min(bucket.min, value);
+        bucket.max = max(bucket.max, value);
+        bucket.sum += value;
+        bucket.count++;
+    }
+
+    xSemaphoreGive(mutex);
+}
+
+size_t TempHistory::readPoints(HistoryResolution res, uint32_t from, uint32_t to,
+                               uint32_t& cursor, HistoryPoint* out, size_t maxPoints) {
+    if (!isReady()) {
+        return 0;
+    }
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+
+    // cursor는 절대 인덱스 - 덮어쓰인 구간은 건너뜀
+    uint32_t tot = total(res);
+    uint32_t cap = capacity(res);
+    uint32_t oldest = tot > cap ? tot - cap : 0;
+    if (cursor < oldest) {
+        cursor = oldest;
+    }
+
+    uint8_t level = res - HISTORY_1M;
+    bool hasOpen = res != HISTORY_RAW && openBucket[level].count > 0;
+    uint32_t end = tot + (hasOpen ? 1 : 0);
+
+    size_t n = 0;
+    while (cursor < end && n < maxPoints) {
+        HistoryPoint point;
+        if (res == HISTORY_RAW) {
+            const TempSample& sample = raw[cursor % cap];
+            point = {sample.t, sample.value, sample.value, sample.value, 1};
+        } else {
+            const TempRollup& bucket = cursor == tot ? openBucket[level] : rollups[level][cursor % cap];
+            point = {bucket.start, bucket.min, bucket.max, bucket.sum / bucket.count, bucket.count};
+        }
+        cursor++;
+
+        if (point.t < from) {
+            continue;
+        }
+        if (point.t > to) {
+            cursor = end;  // 시간순이므로 이후는 모두 범위 밖
+            break;
+        }
+        out[n++] = point;
+    }
+
+    xSemaphoreGive(mutex);
+    return n;
+}
+
+bool TempHistory::parseResolution(const String& name, HistoryResolution& res) {
+    if (name == "raw") {
+        res = HISTORY_RAW;
+    } else if (name == "1m" || name.length() == 0) {
+        res = HISTORY_1M;
+    } else if (name == "15m") {
+        res = HISTORY_15M;
+    } else if (name == "1h") {
+        res = HISTORY_1H;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* TempHistory::resolutionName(HistoryResolution res) {
+    static const char* names[] = {"raw", "1m", "15m", "1h"};
+    return names[res];
+}
+
+size_t TempHistory::memoryUsage() {
+    return HISTORY_RAW_SAMPLES * sizeof(TempSample) +
+           (HISTORY_1M_BUCKETS + HISTORY_15M_BUCKETS + HISTORY_1H_BUCKETS) * sizeof(TempRollup);
+}
@@ -0,0 +1,68 @@
+#ifndef TEMP_HISTORY_H
+#define TEMP_HISTORY_H
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "config.h"
+
+// 원본 샘플 (타임스탬프는 부팅 후 초 - API 페이로드의 timestamp와 같은 기준)
+struct TempSample {
+    uint32_t t;
+    float value;
+};
+
+// 고정 구간 롤업 (min/max/avg = sum/count)
+struct TempRollup {
+    uint32_t start;
+    float min;
+    float max;
+    float sum;
+    uint32_t count;
+};
+
+enum HistoryResolution {
+    HISTORY_RAW,
+    HISTORY_1M,
+    HISTORY_15M,
+    HISTORY_1H
+};
+
+// 조회 결과 한 점 (raw는 min = max = avg, count = 1)
+struct HistoryPoint {
+    uint32_t t;
+    float min;
+    float max;
+    float avg;
+    uint32_t count;
+};
+
+// PSRAM 고정 크기 링에 원본 샘플과 1분/15분/1시간 롤업을 보관
+// 백엔드가 꺼져 있어도 기기에서 바로 차트 데이터를 조회할 수 있음
+class TempHistory {
+private:
+    static const uint8_t ROLLUP_LEVELS = 3;
+
+    static TempSample* raw;
+    static uint32_t rawTotal;
+    static TempRollup* rollups[ROLLUP_LEVELS];
+    static uint32_t rollupTotal[ROLLUP_LEVELS];
+    static TempRollup openBucket[ROLLUP_LEVELS];   // 아직 닫히지 않은 현재 구간
+    static SemaphoreHandle_t mutex;
+
+    static uint32_t capacity(HistoryResolution res);
+    static uint32_t period(uint8_t level);
+    static uint32_t total(HistoryResolution res);
+
+public:
+    static bool init();
+    static bool isReady();
+    static void record(float value, uint32_t t);
+    static size_t readPoints(HistoryResolution res, uint32_t from, uint32_t to,
+                             uint32_t& cursor, HistoryPoint* out, size_t maxPoints);
+    static bool parseResolution(const String& name, HistoryResolution& res);
+    static const char* resolutionName(HistoryResolution res);
+    static size_t memoryUsage();
+};
+
+#endif // TEMP_HISTORY_H
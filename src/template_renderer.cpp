@@ -0,0 +1,96 @@
+#include "template_renderer.h"
+
+#define TEMPLATE_MAX_KEY 24
+#define TEMPLATE_RAW_VALUE 64
+
+void TemplateRenderer::begin(TemplateStream& st, const char* page, TemplateResolver resolve, const String& context) {
+    st.page = page;
+    st.length = strlen(page);
+    st.pos = 0;
+    st.resolve = resolve;
+    st.context = context;
+    st.valueLen = 0;
+    st.valuePos = 0;
+}
+
+bool TemplateRenderer::keyEquals(const char* key, size_t keyLen, const char* name) {
+    return strlen(name) == keyLen && memcmp(key, name, keyLen) == 0;
+}
+
+void TemplateRenderer::setValue(TemplateStream& st, const char* raw) {
+    // 사용자 입력(SSID 등)이 들어갈 수 있으므로 항상 HTML 이스케이프
+    size_t len = 0;
+    for (const char* c = raw; *c; c++) {
+        const char* entity = nullptr;
+        switch (*c) {
+            case '&': entity = "&amp;"; break;
+            case '<': entity = "&lt;"; break;
+            case '>': entity = "&gt;"; break;
+            case '"': entity = "&quot;"; break;
+            case '\'': entity = "&#39;"; break;
+        }
+        size_t n = entity ? strlen(entity) : 1;
+        if (len + n > sizeof(st.value)) {
+            break;
+        }
+        if (entity) {
+            memcpy(st.value + len, entity, n);
+        } else {
+            st.value[len] = *c;
+        }
+        len += n;
+    }
+    st.valueLen = len;
+    st.valuePos = 0;
+}
+
+size_t TemplateRenderer::fill(TemplateStream& st, uint8_t* buffer, size_t maxLen) {
+    size_t len = 0;
+
+    while (len < maxLen) {
+        // 치환 값 남은 부분
+        if (st.valuePos < st.valueLen) {
+            size_t n = min(st.valueLen - st.valuePos, maxLen - len);
+            memcpy(buffer + len, st.value + st.valuePos, n);
+            st.valuePos += n;
+            len += n;
+            continue;
+        }
+        if (st.pos >= st.length) {
+            break;
+        }
+
+        // 다음 % 전까지의 정적 부분은 플래시에서 바로 복사
+        const char* start = st.page + st.pos;
+        const char* mark = (const char*)memchr(start, '%', st.length - st.pos);
+        size_t run = mark ? (size_t)(mark - start) : st.length - st.pos;
+        if (run > 0) {
+            size_t n = min(run, maxLen - len);
+            memcpy(buffer + len, start, n);
+            st.pos += n;
+            len += n;
+            continue;
+        }
+
+        // %KEY% 형태이고 아는 키면 치환, 아니면 % 한 글자를 그대로 출력
+        size_t keyStart = st.pos + 1;
+        size_t end = keyStart;
+        while (end < st.length && end - keyStart < TEMPLATE_MAX_KEY &&
+               ((st.page[end] >= 'A' && st.page[end] <= 'Z') || st.page[end] == '_')) {
+            end++;
+        }
+
+        char raw[TEMPLATE_RAW_VALUE];
+        if (end > keyStart && end < st.length && st.page[end] == '%' &&
+            st.resolve(st.page + keyStart, end - keyStart, st.context, raw, sizeof(raw))) {
+            raw[sizeof(raw) - 1] = '\0';
+            setValue(st, raw);
+            st.pos = end + 1;
+        } else {
+            buffer[len++] = '%';
+            st.pos++;
+        }
+    }
+
+    return len;
+}
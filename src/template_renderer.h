@@ -0,0 +1,34 @@
+#ifndef TEMPLATE_RENDERER_H
+#define TEMPLATE_RENDERER_H
+
+#include <Arduino.h>
+
+// 알려진 키의 값을 out에 씀 (모르는 키면 false - 원문 그대로 출력)
+typedef bool (*TemplateResolver)(const char* key, size_t keyLen, const String& context, char* out, size_t outSize);
+
+// 한 응답의 렌더링 위치 - 청크 filler가 호출될 때마다 이어서 채움
+struct TemplateStream {
+    const char* page;        // PROGMEM 페이지 (ESP32는 플래시가 메모리 매핑되어 바로 읽음)
+    size_t length;
+    size_t pos;
+    TemplateResolver resolve;
+    String context;          // 요청별 값 (예: 저장한 SSID)
+    char value[192];         // 현재 치환 값 (HTML 이스케이프 후)
+    size_t valueLen;
+    size_t valuePos;
+};
+
+// PROGMEM 페이지를 한 번만 훑으며 정적 부분은 그대로 복사하고 %KEY% 만 그 자리에서 치환
+// 페이지 전체를 String으로 복사하고 replace() 하던 것과 달리 요청당 작은 고정 상태만 사용
+// CSS의 100% 같은 % 는 키 형태([A-Z_]+)가 아니거나 모르는 키이므로 그대로 나감
+class TemplateRenderer {
+public:
+    static void begin(TemplateStream& st, const char* page, TemplateResolver resolve, const String& context = String());
+    static size_t fill(TemplateStream& st, uint8_t* buffer, size_t maxLen);
+    static bool keyEquals(const char* key, size_t keyLen, const char* name);
+
+private:
+    static void setValue(TemplateStream& st, const char* raw);
+};
+
+#endif // TEMPLATE_RENDERER_H
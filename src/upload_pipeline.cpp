@@ -0,0 +1,378 @@
+#include "upload_pipeline.h"
+#include <WiFi.h>
+#include "debug_system.h"
+#include "backend_client.h"
+#include "offline_queue.h"
+#include "metrics.h"
+#include "status_store.h"
+
+static constexpr char TAG[] = "upload";
+
+static const uint32_t UPLOAD_BUCKETS_MS[] = {50, 100, 250, 500, 1000, 2500, 5000, 10000};
+static const uint8_t UPLOAD_BUCKET_COUNT = sizeof(UPLOAD_BUCKETS_MS) / sizeof(UPLOAD_BUCKETS_MS[0]);
+static MetricHistogram frameLatency("peteye_upload_duration_ms", "Backend POST time", UPLOAD_BUCKETS_MS, UPLOAD_BUCKET_COUNT,
+                                    "type", "frame");
+static MetricHistogram documentLatency("peteye_upload_duration_ms", "Backend POST time", UPLOAD_BUCKETS_MS, UPLOAD_BUCKET_COUNT,
+                                       "type", "document");
+static MetricCounter frameBytes("peteye_upload_bytes_total", "Bytes delivered to the backend", "type", "frame");
+static MetricCounter documentBytes("peteye_upload_bytes_total", "Bytes delivered to the backend", "type", "document");
+static MetricCounter uploadFailures("peteye_upload_failures_total", "Backend POSTs that did not return 200");
+static MetricGauge firstUpload("peteye_boot_to_first_upload_ms", "Time from boot to the first successful backend upload");
+
+QueueHandle_t UploadPipeline::jobQueue = nullptr;
+QueueHandle_t UploadPipeline::deferQueue = nullptr;
+SemaphoreHandle_t UploadPipeline::enqueueMutex = nullptr;
+TaskHandle_t UploadPipeline::uploadTask = nullptr;
+UploadStats UploadPipeline::stats = {};
+unsigned long UploadPipeline::lastReplayFailure = 0;
+
+void UploadPipeline::init() {
+    if (uploadTask != nullptr) {
+        return;
+    }
+
+    jobQueue = xQueueCreate(UPLOAD_QUEUE_LEN, sizeof(UploadJob));
+    deferQueue = xQueueCreate(UPLOAD_QUEUE_LEN, sizeof(UploadJob));
+    enqueueMutex = xSemaphoreCreateMutex();
+    OfflineQueue::init();
+
+    // 카메라/센서 태스크는 코어 1에서 돌기 때문에 업로드는 코어 0에서 처리
+    xTaskCreatePinnedToCore(uploadLoop, "upload", 8192, nullptr, 1, &uploadTask, 0);
+    LOG_I(TAG, "Upload pipeline started (queue %d)", UPLOAD_QUEUE_LEN);
+}
+
+bool UploadPipeline::enqueueFrame(SharedFrame* frame) {
+    if (frame == nullptr) {
+        return false;
+    }
+
+    UploadJob job = {};
+    job.type = UPLOAD_FRAME;
+    job.frame = frame;
+    job.temperature = StatusStore::currentTemp();
+    return enqueue(job, false);
+}
+
+bool UploadPipeline::enqueueDocument(const char* path, const JsonDocument& doc, bool urgent, size_t* bytes) {
+    UploadJob job = {};
+    job.type = UPLOAD_DOCUMENT;
+    job.format = WireCodec::uploadFormat();
+
+    // 크기를 먼저 재서 딱 맞는 버퍼에 바로 인코딩 (중간 String 없음)
+    size_t capacity = WireCodec::measure(doc, job.format) + 1;
+    job.body = (char*)malloc(capacity);
+    if (job.body == nullptr) {
+        stats.dropped++;
+        return false;
+    }
+    job.bodyLen = WireCodec::encode(doc, job.format, (uint8_t*)job.body, capacity);
+    if (job.bodyLen == 0) {
+        LOG_E(TAG, "❌ Failed to encode document for %s", path);
+        stats.dropped++;
+        releaseJob(job);
+        return false;
+    }
+    strncpy(job.path, path, sizeof(job.path) - 1);
+    if (bytes != nullptr) {
+        *bytes = job.bodyLen;
+    }
+    return enqueue(job, urgent);
+}
+
+bool UploadPipeline::enqueue(UploadJob& job, bool urgent) {
+    if (jobQueue == nullptr) {
+        releaseJob(job);
+        return false;
+    }
+
+    job.urgent = urgent;
+    xSemaphoreTake(enqueueMutex, portMAX_DELAY);
+
+    // 일반 작업은 자리가 있으면 바로 뒤에, 긴급 작업이나 가득 찬 큐는 순서를 맞춰 다시 쌓음
+    bool queued = !urgent && xQueueSendToBack(jobQueue, &job, 0) == pdTRUE;
+    if (!queued) {
+        queued = insertOrdered(job);
+    }
+    if (!queued) {
+        stats.dropped++;
+        xSemaphoreGive(enqueueMutex);
+        releaseJob(job);
+        return false;
+    }
+
+    stats.enqueued++;
+    xSemaphoreGive(enqueueMutex);
+    return true;
+}
+
+// enqueueMutex 안에서 호출 - 큐를 비우고 새 작업의 자리를 정한 뒤 순서대로 되돌림
+// 긴급 작업(경보)은 일반 작업보다 앞에, 긴급 작업끼리는 들어온 순서대로 (해제가 발생을 앞지르지 않도록)
+// 자리가 없으면 가장 오래된 일반 프레임 → 일반 문서 순으로 밀어냄 (pickVictim)
+bool UploadPipeline::insertOrdered(UploadJob& job) {
+    UploadJob pending[UPLOAD_QUEUE_LEN + 1];
+    uint8_t count = 0;
+    while (count < UPLOAD_QUEUE_LEN && xQueueReceive(jobQueue, &pending[count], 0) == pdTRUE) {
+        count++;
+    }
+
+    // 긴급 작업은 항상 앞쪽에 모여 있음
+    uint8_t urgentCount = 0;
+    while (urgentCount < count && pending[urgentCount].urgent) {
+        urgentCount++;
+    }
+
+    // 그 사이 업로드 태스크가 하나 가져갔으면 버릴 필요 없음
+    bool placed = true;
+    if (count == UPLOAD_QUEUE_LEN) {
+        int victim = pickVictim(pending, count, urgentCount, job.urgent);
+        if (victim >= 0) {
+            evict(pending[victim]);
+            for (uint8_t i = victim; i + 1 < count; i++) {
+                pending[i] = pending[i + 1];
+            }
+            count--;
+            if (victim < urgentCount) {
+                urgentCount--;
+            }
+        } else {
+            placed = false;
+        }
+    }
+
+    if (placed) {
+        uint8_t at = job.urgent ? urgentCount : count;
+        for (uint8_t i = count; i > at; i--) {
+            pending[i] = pending[i - 1];
+        }
+        pending[at] = job;
+        count++;
+    }
+
+    for (uint8_t i = 0; i < count; i++) {
+        xQueueSendToBack(jobQueue, &pending[i], 0);
+    }
+    return placed;
+}
+
+// 스냅샷은 곧 새로 찍히므로 먼저 버리고, 문서(텔레메트리 배치 등)는 프레임이 없을 때만 밀어냄
+// 일반 작업이 없으면 긴급 작업이 들어올 때만 가장 오래된 긴급 작업
+int UploadPipeline::pickVictim(const UploadJob* pending, uint8_t count, uint8_t urgentCount, bool urgent) {
+    for (uint8_t i = urgentCount; i < count; i++) {
+        if (pending[i].type == UPLOAD_FRAME) {
+            return i;
+        }
+    }
+    if (urgentCount < count) {
+        return urgentCount;
+    }
+    return urgent ? 0 : -1;
+}
+
+// 밀려난 문서는 버리지 않고 업로드 태스크를 거쳐 OfflineQueue에 보관 (OfflineQueue는 업로드 태스크 전용)
+void UploadPipeline::evict(UploadJob& job) {
+    if (job.type == UPLOAD_DOCUMENT && xQueueSendToBack(deferQueue, &job, 0) == pdTRUE) {
+        stats.deferred++;
+        return;
+    }
+    releaseJob(job);
+    stats.dropped++;
+}
+
+void UploadPipeline::releaseJob(UploadJob& job) {
+    CameraManager::releaseShared(job.frame);
+    free(job.body);
+    job.frame = nullptr;
+    job.body = nullptr;
+}
+
+uint32_t UploadPipeline::queueDepth() {
+    return jobQueue ? uxQueueMessagesWaiting(jobQueue) : 0;
+}
+
+void UploadPipeline::uploadLoop(void* param) {
+    for (;;) {
+        OfflineQueue::maintain();
+
+        UploadJob job;
+        while (xQueueReceive(deferQueue, &job, 0) == pdTRUE) {
+            OfflineQueue::store(job);
+            releaseJob(job);
+        }
+
+        // 실시간 작업이 우선 - 큐가 OFFLINE_REPLAY_INTERVAL 동안 비어 있을 때만 보관분을 하나씩 재전송
+        if (xQueueReceive(jobQueue, &job, pdMS_TO_TICKS(OFFLINE_REPLAY_INTERVAL)) == pdTRUE) {
+            processJob(job);
+        } else {
+            replayNext();
+        }
+    }
+}
+
+void UploadPipeline::processJob(UploadJob& job) {
+    unsigned long start = millis();
+    int httpCode = send(job);
+    uint32_t latency = millis() - start;
+
+    stats.lastLatencyMs = latency;
+    stats.avgLatencyMs = stats.avgLatencyMs == 0 ? latency : (stats.avgLatencyMs * 7 + latency) / 8;
+    if (latency > stats.maxLatencyMs) {
+        stats.maxLatencyMs = latency;
+    }
+
+    if (httpCode == HTTP_CODE_OK) {
+        stats.uploaded++;
+        noteDelivered();
+        lastReplayFailure = 0;  // 연결이 돌아왔으므로 재전송 대기 해제
+    } else {
+        stats.failed++;
+        if (isRetryable(httpCode)) {
+            OfflineQueue::store(job);
+        }
+    }
+    releaseJob(job);
+}
+
+void UploadPipeline::replayNext() {
+    if (OfflineQueue::pending() == 0 || !StatusStore::wifiConnected()) {
+        return;
+    }
+    if (lastReplayFailure != 0 && millis() - lastReplayFailure < OFFLINE_RETRY_BACKOFF) {
+        return;
+    }
+
+    UploadJob job;
+    if (!OfflineQueue::peek(job)) {
+        return;
+    }
+
+    int httpCode = send(job);
+    releaseJob(job);
+
+    if (httpCode == HTTP_CODE_OK) {
+        OfflineQueue::pop(true);
+        noteDelivered();
+    } else if (!isRetryable(httpCode)) {
+        OfflineQueue::pop(false);  // 4xx - 다시 보내도 결과가 같으므로 버림
+    } else {
+        lastReplayFailure = millis();
+    }
+}
+
+// 부팅 후 첫 업로드 시점 기록 - WiFi 빠른 재접속 효과 확인용
+void UploadPipeline::noteDelivered() {
+    if (stats.firstUploadMs == 0) {
+        stats.firstUploadMs = millis();
+        firstUpload.set(stats.firstUploadMs);
+        LOG_I(TAG, "First upload %u ms after boot", stats.firstUploadMs);
+    }
+}
+
+int UploadPipeline::send(UploadJob& job) {
+    return job.type == UPLOAD_FRAME ? uploadFrame(job) : uploadDocument(job);
+}
+
+bool UploadPipeline::isRetryable(int httpCode) {
+    // 연결 실패, 서버 오류, 과부하만 나중에 다시 보냄
+    return httpCode <= 0 || httpCode == 429 || httpCode >= 500;
+}
+
+int UploadPipeline::uploadFrame(const UploadJob& job) {
+    if (!StatusStore::wifiConnected()) {
+        LOG_I(TAG, "Cannot upload image - WiFi not connected");
+        return HTTPC_ERROR_NOT_CONNECTED;
+    }
+
+    BackendHeader headers[] = {
+        {"X-Device-ID", StatusStore::deviceId()},
+        {"X-Timestamp", String(job.frame->timestamp)},
+        {"X-Temperature", String(job.temperature, 1)},
+        {"X-RSSI", String(WiFi.RSSI())},
+        {"X-Free-Heap", String(ESP.getFreeHeap())}
+    };
+
+    // 바이너리 이미지 데이터 직접 전송 (keep-alive 연결 재사용)
+    unsigned long start = millis();
+    int httpCode = BackendClient::post("/upload", "image/jpeg", job.frame->buf, job.frame->len,
+                                       UPLOAD_TIMEOUT, headers, 5);
+    frameLatency.observe(millis() - start);
+    if (httpCode == HTTP_CODE_OK) {
+        frameBytes.inc(job.frame->len);
+    } else {
+        uploadFailures.inc();
+    }
+
+    if (httpCode > 0) {
+        if (httpCode == HTTP_CODE_OK) {
+            LOG_I(TAG, "✅ Image sent successfully");
+        } else {
+            LOG_E(TAG, "❌ Image upload failed - HTTP code: %d", httpCode);
+        }
+    } else {
+        LOG_E(TAG, "❌ Image POST failed: %s", HTTPClient::errorToString(httpCode).c_str());
+    }
+    return httpCode;
+}
+
+int UploadPipeline::uploadDocument(UploadJob& job) {
+    if (!StatusStore::wifiConnected()) {
+        LOG_I(TAG, "Cannot send %s - WiFi not connected", job.path);
+        return HTTPC_ERROR_NOT_CONNECTED;
+    }
+
+    unsigned long start = millis();
+    int httpCode = postDocument(job);
+
+    // 백엔드가 MessagePack을 모르면 JSON으로 바꿔 한 번 더 보내고 이후로는 JSON 사용
+    if (httpCode == 415 && job.format == WIRE_MSGPACK) {
+        WireCodec::markMsgPackRejected();
+
+        JsonDocument doc;
+        if (WireCodec::decode((const uint8_t*)job.body, job.bodyLen, WIRE_MSGPACK, doc)) {
+            size_t capacity = WireCodec::measure(doc, WIRE_JSON) + 1;
+            char* json = (char*)malloc(capacity);
+            if (json != nullptr) {
+                free(job.body);
+                job.body = json;
+                job.bodyLen = WireCodec::encode(doc, WIRE_JSON, (uint8_t*)json, capacity);
+                job.format = WIRE_JSON;
+                httpCode = postDocument(job);
+            }
+        }
+    }
+
+    documentLatency.observe(millis() - start);
+    if (httpCode == HTTP_CODE_OK) {
+        documentBytes.inc(job.bodyLen);
+    } else {
+        uploadFailures.inc();
+    }
+
+    if (httpCode > 0) {
+        if (httpCode != HTTP_CODE_OK) {
+            LOG_E(TAG, "❌ HTTP error code: %d (%s)", httpCode, job.path);
+        }
+    } else {
+        LOG_E(TAG, "❌ HTTP POST failed: %s", HTTPClient::errorToString(httpCode).c_str());
+    }
+    return httpCode;
+}
+
+int UploadPipeline::postDocument(const UploadJob& job) {
+    return BackendClient::post(job.path, WireCodec::contentType(job.format),
+                               (const uint8_t*)job.body, job.bodyLen, API_TIMEOUT);
+}
+
+void UploadPipeline::getStats(JsonObject obj) {
+    obj["queueDepth"] = queueDepth();
+    obj["queueCapacity"] = UPLOAD_QUEUE_LEN;
+    obj["enqueued"] = stats.enqueued;
+    obj["uploaded"] = stats.uploaded;
+    obj["failed"] = stats.failed;
+    obj["dropped"] = stats.dropped;
+    obj["deferred"] = stats.deferred;
+    obj["lastLatencyMs"] = stats.lastLatencyMs;
+    obj["avgLatencyMs"] = stats.avgLatencyMs;
+    obj["maxLatencyMs"] = stats.maxLatencyMs;
+    obj["bootToFirstUploadMs"] = stats.firstUploadMs;
+    obj["offlinePending"] = OfflineQueue::pending();
+}
@@ -0,0 +1,78 @@
+#ifndef UPLOAD_PIPELINE_H
+#define UPLOAD_PIPELINE_H
+
+#include <ArduinoJson.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "config.h"
+#include "camera_manager.h"
+#include "wire_format.h"
+
+enum UploadType {
+    UPLOAD_FRAME,   // JPEG 스냅샷 → /upload
+    UPLOAD_DOCUMENT // JSON/MessagePack 문서 → 임의 경로
+};
+
+// 업로드 대기 중인 작업 하나
+struct UploadJob {
+    UploadType type;
+    SharedFrame* frame;
+    char* body;
+    size_t bodyLen;
+    WireFormat format;
+    char path[24];
+    float temperature;   // 캡처 시점 온도
+    bool urgent;         // 경보 등 - 일반 작업보다 앞에 (긴급 작업끼리는 순서 유지), 일반 작업 때문에 버리지 않음
+};
+
+struct UploadStats {
+    uint32_t enqueued;
+    uint32_t uploaded;
+    uint32_t failed;
+    uint32_t dropped;          // 큐가 가득 차서 버린 오래된 작업
+    uint32_t deferred;         // 큐에서 밀려나 OfflineQueue로 보낸 문서
+    uint32_t lastLatencyMs;
+    uint32_t avgLatencyMs;
+    uint32_t maxLatencyMs;
+    uint32_t firstUploadMs;    // 부팅 ~ 첫 업로드 성공 (0 = 아직 없음)
+};
+
+// 캡처/센서(생산자) → 제한 큐 → 업로드 태스크(소비자, 코어 0)
+// 카메라/센서 태스크는 큐에 넣기만 하므로 백엔드가 느리거나 죽어도 주기를 유지함
+// 전송 실패분은 OfflineQueue에 보관했다가 큐가 한가할 때 순서대로 재전송
+class UploadPipeline {
+private:
+    static QueueHandle_t jobQueue;
+    static QueueHandle_t deferQueue;        // 큐에서 밀려난 문서 → 업로드 태스크가 OfflineQueue에 보관
+    static SemaphoreHandle_t enqueueMutex;   // 생산자(카메라/센서 태스크)끼리 가득 찬 큐 정리가 겹치지 않도록
+    static TaskHandle_t uploadTask;
+    static UploadStats stats;
+    static unsigned long lastReplayFailure;
+
+    static void uploadLoop(void* param);
+    static void processJob(UploadJob& job);
+    static void replayNext();
+    static int send(UploadJob& job);
+    static bool isRetryable(int httpCode);
+    static bool enqueue(UploadJob& job, bool urgent);
+    static bool insertOrdered(UploadJob& job);
+    static int pickVictim(const UploadJob* pending, uint8_t count, uint8_t urgentCount, bool urgent);
+    static void evict(UploadJob& job);
+    static void releaseJob(UploadJob& job);
+    static void noteDelivered();
+    static int uploadFrame(const UploadJob& job);
+    static int uploadDocument(UploadJob& job);
+    static int postDocument(const UploadJob& job);
+
+public:
+    static void init();
+    static bool enqueueFrame(SharedFrame* frame);
+    static bool enqueueDocument(const char* path, const JsonDocument& doc, bool urgent = false,
+                                size_t* bytes = nullptr);
+    static uint32_t queueDepth();
+    static void getStats(JsonObject obj);
+};
+
+#endif // UPLOAD_PIPELINE_H
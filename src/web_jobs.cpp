@@ -0,0 +1,133 @@
+#include "web_jobs.h"
+#include "debug_system.h"
+
+WebJob WebJobs::jobs[WEB_JOB_SLOTS];
+QueueHandle_t WebJobs::workerQueue = nullptr;
+QueueHandle_t WebJobs::sensorQueue = nullptr;
+SemaphoreHandle_t WebJobs::jobsMutex = nullptr;
+TaskHandle_t WebJobs::workerTask = nullptr;
+uint32_t WebJobs::nextId = 1;
+
+void WebJobs::init() {
+    if (workerTask != nullptr) {
+        return;
+    }
+
+    for (int i = 0; i < WEB_JOB_SLOTS; i++) {
+        jobs[i].id = 0;
+        jobs[i].state = WEB_JOB_EMPTY;
+    }
+
+    jobsMutex = xSemaphoreCreateMutex();
+    workerQueue = xQueueCreate(WEB_JOB_SLOTS, sizeof(uint8_t));
+    sensorQueue = xQueueCreate(WEB_JOB_SLOTS, sizeof(uint8_t));
+    xTaskCreatePinnedToCore(workerLoop, "web_jobs", WEB_JOB_STACK, nullptr, 1, &workerTask, 0);
+}
+
+uint32_t WebJobs::submit(const char* name, WebJobFunction function, bool jsonResult, WebJobContext context) {
+    if (workerTask == nullptr) {
+        return 0;
+    }
+
+    // 빈 슬롯, 없으면 가장 오래전에 끝난 작업의 슬롯을 재사용
+    xSemaphoreTake(jobsMutex, portMAX_DELAY);
+    int slot = -1;
+    for (int i = 0; i < WEB_JOB_SLOTS; i++) {
+        if (jobs[i].state == WEB_JOB_EMPTY) {
+            slot = i;
+            break;
+        }
+        if (jobs[i].state == WEB_JOB_DONE && (slot < 0 || jobs[i].finishedAt < jobs[slot].finishedAt)) {
+            slot = i;
+        }
+    }
+
+    if (slot < 0) {
+        xSemaphoreGive(jobsMutex);
+        return 0;  // 모든 슬롯이 대기/실행 중
+    }
+
+    WebJob& job = jobs[slot];
+    job.id = nextId++;
+    job.name = name;
+    job.function = function;
+    job.jsonResult = jsonResult;
+    job.state = WEB_JOB_QUEUED;
+    job.result = "";
+    job.submittedAt = millis();
+    job.startedAt = 0;
+    job.finishedAt = 0;
+    uint32_t id = job.id;
+    xSemaphoreGive(jobsMutex);
+
+    uint8_t index = slot;
+    xQueueSend(context == WEB_JOB_SENSORS ? sensorQueue : workerQueue, &index, 0);
+    return id;
+}
+
+void WebJobs::workerLoop(void* param) {
+    for (;;) {
+        uint8_t slot;
+        if (xQueueReceive(workerQueue, &slot, portMAX_DELAY) == pdTRUE) {
+            run(slot);
+        }
+    }
+}
+
+void WebJobs::runSensorJobs() {
+    // sensors 태스크 주기 한 번에 하나만 실행
+    uint8_t slot;
+    if (sensorQueue != nullptr && xQueueReceive(sensorQueue, &slot, 0) == pdTRUE) {
+        run(slot);
+    }
+}
+
+void WebJobs::run(uint8_t slot) {
+    WebJob& job = jobs[slot];
+    job.startedAt = millis();
+    job.state = WEB_JOB_RUNNING;
+
+    String result = job.function();
+
+    xSemaphoreTake(jobsMutex, portMAX_DELAY);
+    job.result = result;
+    job.finishedAt = millis();
+    job.state = WEB_JOB_DONE;
+    xSemaphoreGive(jobsMutex);
+}
+
+bool WebJobs::getJob(uint32_t id, JsonObject obj) {
+    bool found = false;
+    xSemaphoreTake(jobsMutex, portMAX_DELAY);
+    for (int i = 0; i < WEB_JOB_SLOTS; i++) {
+        const WebJob& job = jobs[i];
+        if (job.state == WEB_JOB_EMPTY || job.id != id) {
+            continue;
+        }
+
+        obj["id"] = job.id;
+        obj["name"] = job.name;
+        obj["status"] = stateName(job.state);
+        if (job.state == WEB_JOB_DONE) {
+            obj["durationMs"] = job.finishedAt - job.startedAt;
+            if (job.jsonResult) {
+                obj["result"] = serialized(job.result);
+            } else {
+                obj["result"] = job.result;
+            }
+        }
+        found = true;
+        break;
+    }
+    xSemaphoreGive(jobsMutex);
+    return found;
+}
+
+const char* WebJobs::stateName(WebJobState state) {
+    switch (state) {
+        case WEB_JOB_QUEUED: return "queued";
+        case WEB_JOB_RUNNING: return "running";
+        case WEB_JOB_DONE: return "done";
+        default: return "empty";
+    }
+}
@@ -0,0 +1,63 @@
+#ifndef WEB_JOBS_H
+#define WEB_JOBS_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "config.h"
+
+// 작업 함수 - 결과 본문(텍스트 또는 JSON)을 돌려줌
+typedef String (*WebJobFunction)();
+
+enum WebJobState {
+    WEB_JOB_EMPTY,
+    WEB_JOB_QUEUED,
+    WEB_JOB_RUNNING,
+    WEB_JOB_DONE
+};
+
+// 어디서 실행할지
+enum WebJobContext {
+    WEB_JOB_WORKER,  // 작업 태스크 (코어 0) - 네트워크, 스캔, 재부팅 등
+    WEB_JOB_SENSORS  // sensors 태스크 (코어 1) - 센서/카메라 하드웨어를 쓰는 작업
+};
+
+struct WebJob {
+    uint32_t id;
+    const char* name;
+    WebJobFunction function;
+    bool jsonResult;
+    volatile WebJobState state;
+    String result;
+    unsigned long submittedAt;
+    unsigned long startedAt;
+    unsigned long finishedAt;
+};
+
+// 비동기 웹 핸들러가 오래 걸리는 일을 넘기는 곳
+// 핸들러는 바로 202 + 작업 ID를 돌려주고, 클라이언트는 /api/job?id= 로 결과를 조회
+class WebJobs {
+private:
+    static WebJob jobs[WEB_JOB_SLOTS];
+    static QueueHandle_t workerQueue;
+    static QueueHandle_t sensorQueue;
+    static SemaphoreHandle_t jobsMutex;
+    static TaskHandle_t workerTask;
+    static uint32_t nextId;
+
+    static void workerLoop(void* param);
+    static void run(uint8_t slot);
+
+public:
+    static void init();
+    static uint32_t submit(const char* name, WebJobFunction function, bool jsonResult = false,
+                           WebJobContext context = WEB_JOB_WORKER);
+    static void runSensorJobs();
+    static bool getJob(uint32_t id, JsonObject obj);
+    static const char* stateName(WebJobState state);
+};
+
+#endif // WEB_JOBS_H
@@ -86,23 +86,23 @@ const char INDEX_HTML[] PROGMEM = R"rawliteral(
             <h3>System Status</h3>
             <div class="status-item">
                 <span>Device ID:</span>
-                <span>%DEVICE_ID%</span>
+                <span id="deviceId">-</span>
             </div>
             <div class="status-item">
                 <span>WiFi Status:</span>
-                <span class="%WIFI_CLASS%">%WIFI_STATUS%</span>
+                <span id="wifiStatus">-</span>
             </div>
             <div class="status-item">
                 <span>IP Address:</span>
-                <span>%IP_ADDRESS%</span>
+                <span id="ipAddress">-</span>
             </div>
             <div class="status-item">
                 <span>Camera:</span>
-                <span class="%CAM_CLASS%">%CAM_STATUS%</span>
+                <span id="camStatus">-</span>
             </div>
             <div class="status-item">
                 <span>Temperature:</span>
-                <span>%TEMPERATURE%</span>
+                <span id="temperature">-</span>
             </div>
         </div>
         
@@ -122,14 +122,37 @@ const char INDEX_HTML[] PROGMEM = R"rawliteral(
     </div>
     
     <script>
+        // 페이지는 gzip + ETag로 캐시되는 정적 파일이므로 상태 값은 /api/status 에서 따로 가져옴
+        function setStatus(id, text, online) {
+            const el = document.getElementById(id);
+            el.textContent = text;
+            if (online !== undefined) el.className = online ? 'online' : 'offline';
+        }
+        
+        function loadStatus() {
+            fetch('/api/status').then(r => r.json()).then(data => {
+                setStatus('deviceId', data.deviceId);
+                setStatus('wifiStatus', data.wifiConnected ? 'Connected' : 'Not Connected', data.wifiConnected);
+                setStatus('ipAddress', data.ip);
+                setStatus('camStatus', data.cameraReady ? 'Ready' : 'Not Initialized', data.cameraReady);
+                setStatus('temperature', data.temperature.toFixed(1) + '°C');
+            });
+        }
+        
+        // 캐시된 목록을 바로 보여주고, 기기가 다시 스캔 중이면 잠시 후 한 번 더 조회
         function scanNetworks() {
             const resultsDiv = document.getElementById('scanResults');
-            resultsDiv.innerHTML = '<div style="padding: 10px;">Scanning...</div>';
+            if (!resultsDiv.children.length) {
+                resultsDiv.innerHTML = '<div style="padding: 10px;">Scanning...</div>';
+            }
             resultsDiv.style.display = 'block';
             
-            fetch('/scan')
-                .then(response => response.json())
+            fetch('/scan').then(r => r.json())
                 .then(data => {
+                    if (data.scanning) setTimeout(() => {
+                        if (resultsDiv.style.display !== 'none') scanNetworks();
+                    }, 1000);
+                    if (!data.networks.length && data.scanning) return;
                     resultsDiv.innerHTML = '';
                     data.networks.forEach(network => {
                         const item = document.createElement('div');
@@ -143,11 +166,35 @@ const char INDEX_HTML[] PROGMEM = R"rawliteral(
                     });
                 });
         }
+        
+        loadStatus();
     </script>
 </body>
 </html>
 )rawliteral";
 
+// WiFi 설정 저장 완료 페이지 (%SSID% 는 요청값, HTML 이스케이프됨)
+const char SAVED_HTML[] PROGMEM = R"rawliteral(<html><head><meta charset='utf-8'></head>
+<body style='font-family: Arial; text-align: center; padding: 50px;'>
+<h2>✅ Configuration Saved!</h2>
+<p>Device will restart and connect to: <strong>%SSID%</strong></p>
+<p>After restart:</p>
+<ol style='text-align: left; display: inline-block;'>
+<li>Connect your device to the same WiFi network</li>
+<li>Access PetEye at: <strong>http://peteye.local</strong></li>
+<li>Or check Serial Monitor for IP address</li>
+</ol>
+<p>Restarting in 5 seconds...</p>
+</body></html>
+)rawliteral";
+
+const char STREAM_HTML[] PROGMEM = R"rawliteral(<html><body style='text-align:center;'>
+<h1>PetEye Camera Stream</h1>
+<img src='http://%IP_ADDRESS%:%STREAM_PORT%/stream' style='width:100%; max-width:640px;'/>
+<br><a href='/'>Back to Configuration</a>
+</body></html>
+)rawliteral";
+
 const char DEBUG_HTML[] PROGMEM = R"rawliteral(
 <!DOCTYPE html>
 <html>
@@ -210,35 +257,62 @@ const char DEBUG_HTML[] PROGMEM = R"rawliteral(
         <button onclick="testCamera()">Test Camera</button>
         <button onclick="testTemp()">Test Temp</button>
         <button onclick="testAPI()">Test API</button>
+        <button onclick="testWire()">Test Wire</button>
         <button onclick="reboot()">Reboot</button>
     </div>
     
     <script>
+        var consoleEl = document.getElementById('console');
+        var lines = [];
+        
+        function showStatus(data) {
+            if ('freeHeap' in data) document.getElementById('freeHeap').textContent = data.freeHeap;
+            if ('uptime' in data) document.getElementById('uptime').textContent = data.uptime;
+            if ('rssi' in data) document.getElementById('rssi').textContent = data.rssi;
+            if ('temperature' in data) document.getElementById('temp').textContent = data.temperature;
+        }
+        
+        function appendLog(line) {
+            lines.push(line);
+            if (lines.length > 100) lines.shift();
+            consoleEl.textContent = lines.join('\n');
+            consoleEl.scrollTop = consoleEl.scrollHeight;
+        }
+        
+        // EventSource를 지원하지 않는 브라우저용 폴링
         function updateConsole() {
             fetch('/api/debug').then(r => r.text()).then(data => {
-                document.getElementById('console').textContent = data;
-            });
-            
-            fetch('/api/status').then(r => r.json()).then(data => {
-                document.getElementById('freeHeap').textContent = data.freeHeap;
-                document.getElementById('uptime').textContent = data.uptime;
-                document.getElementById('rssi').textContent = data.rssi;
-                document.getElementById('temp').textContent = data.temperature;
+                consoleEl.textContent = data;
             });
+            fetch('/api/status').then(r => r.json()).then(showStatus);
+        }
+        
+        // 새 로그 줄과 바뀐 상태만 푸시로 받음
+        function connectEvents() {
+            var events = new EventSource('/events');
+            events.onopen = () => { lines = []; };
+            events.addEventListener('log', e => e.data.split('\n').forEach(appendLog));
+            events.addEventListener('status', e => showStatus(JSON.parse(e.data)));
+            events.addEventListener('clear', () => { lines = []; consoleEl.textContent = ''; });
         }
         
         function clearConsole() { fetch('/api/clear', {method: 'POST'}); }
         function testCamera() { fetch('/api/test/camera', {method: 'POST'}); }
         function testTemp() { fetch('/api/test/temperature', {method: 'POST'}); }
         function testAPI() { fetch('/api/test/api', {method: 'POST'}); }
+        function testWire() { fetch('/api/test/wire', {method: 'POST'}); }
         function reboot() {
             if(confirm('Reboot device?')) {
                 fetch('/api/reboot', {method: 'POST'});
             }
         }
         
-        setInterval(updateConsole, 2000);
-        updateConsole();
+        if (window.EventSource) {
+            connectEvents();
+        } else {
+            setInterval(updateConsole, 2000);
+            updateConsole();
+        }
     </script>
 </body>
 </html>
@@ -1,199 +1,507 @@
 #include "web_server.h"
 #include "web_pages.h"
+#include "web_pages_gz.h"  // tools/gzip_pages.py 가 빌드 전에 생성
 #include "wifi_manager.h"
 #include "debug_system.h"
 #include "sensor_manager.h"
 #include "camera_manager.h"
+#include "stream_server.h"
+#include "upload_pipeline.h"
+#include "temp_history.h"
+#include "anomaly_detector.h"
+#include "telemetry_batcher.h"
+#include "wire_format.h"
+#include "backend_client.h"
+#include "offline_queue.h"
+#include "event_stream.h"
+#include "web_jobs.h"
+#include "template_renderer.h"
+#include "metrics.h"
+#include "loop_profiler.h"
+#include "scheduler.h"
+#include "app_tasks.h"
+#include "status_store.h"
 #include <ArduinoJson.h>
-#include <HTTPClient.h>
+#include <memory>
 #include <OneWire.h>  // 온도 센서 진단용 추가
 
-WebServer WebServerManager::server(WEB_SERVER_PORT);
+static constexpr char TAG[] = "web";
+
+// 핸들러 실행 시간 (us) - 비동기 응답의 실제 전송 시간은 포함되지 않음
+static const uint32_t HTTP_BUCKETS_US[] = {100, 500, 1000, 5000, 10000, 50000, 100000};
+
+AsyncWebServer WebServerManager::server(WEB_SERVER_PORT);
 
 void WebServerManager::init() {
     // 메인 페이지
-    server.on("/", HTTP_GET, handleRoot);
-    server.on("/debug", HTTP_GET, handleDebugPage);
-    server.on("/scan", HTTP_GET, handleScan);
-    server.on("/save", HTTP_POST, handleSave);
-    server.on("/stream", HTTP_GET, handleStream);
+    on("/", HTTP_GET, handleRoot);
+    on("/debug", HTTP_GET, handleDebugPage);
+    on("/scan", HTTP_GET, handleScan);
+    on("/save", HTTP_POST, handleSave);
+    on("/stream", HTTP_GET, handleStream);
     
     // API 엔드포인트
-    server.on("/api/debug", HTTP_GET, handleAPIDebug);
-    server.on("/api/status", HTTP_GET, handleAPIStatus);
-    server.on("/api/clear", HTTP_POST, handleAPIClear);
-    server.on("/api/test/camera", HTTP_POST, handleAPITestCamera);
-    server.on("/api/test/temperature", HTTP_POST, handleAPITestTemperature);
-    server.on("/api/test/api", HTTP_POST, handleAPITestAPI);
-    server.on("/api/reboot", HTTP_POST, handleAPIReboot);
+    on("/api/debug", HTTP_GET, handleAPIDebug);
+    on("/api/status", HTTP_GET, handleAPIStatus);
+    on("/api/job", HTTP_GET, handleAPIJob);
+    on("/api/stream/stats", HTTP_GET, handleAPIStreamStats);
+    on("/api/events/stats", HTTP_GET, handleAPIEventStats);
+    on("/api/upload/stats", HTTP_GET, handleAPIUploadStats);
+    on("/api/telemetry/stats", HTTP_GET, handleAPITelemetryStats);
+    on("/api/backend/stats", HTTP_GET, handleAPIBackendStats);
+    on("/api/offline/stats", HTTP_GET, handleAPIOfflineStats);
+    on("/api/wifi/stats", HTTP_GET, handleAPIWiFiStats);
+    on("/api/history", HTTP_GET, handleAPIHistory);
+    on("/api/clear", HTTP_POST, handleAPIClear);
+    on("/api/test/camera", HTTP_POST, handleAPITestCamera);
+    on("/api/test/temperature", HTTP_POST, handleAPITestTemperature);
+    on("/api/test/api", HTTP_POST, handleAPITestAPI);
+    on("/api/test/wire", HTTP_POST, handleAPITestWire);
+    on("/api/wire", HTTP_POST, handleAPIWire);
+    on("/api/log/level", HTTP_GET | HTTP_POST, handleAPILogLevel);
+    on("/api/log/raw", HTTP_GET, handleAPILogRaw);
+    on("/api/profile", HTTP_GET | HTTP_POST, handleAPIProfile);
+    on("/api/tasks", HTTP_GET, handleAPITasks);
+    on("/api/scheduler", HTTP_GET | HTTP_POST, handleAPIScheduler);
+    on("/api/reboot", HTTP_POST, handleAPIReboot);
+    
+    // Prometheus 지표
+    on("/metrics", HTTP_GET, handleMetrics);
     
     // Favicon 처리 (404 방지)
-    server.on("/favicon.ico", HTTP_GET, []() {
-        server.send(204);  // No content
+    server.on("/favicon.ico", HTTP_GET, [](AsyncWebServerRequest* request) {
+        request->send(204);  // No content
     });
     
     server.onNotFound(handleNotFound);
     
+    // 오래 걸리는 작업 실행기 및 콘솔 이벤트 스트림 (/events)
+    WebJobs::init();
+    EventStream::init(server);
+    
     server.begin();
-    DebugSystem::log("Web server started on port " + String(WEB_SERVER_PORT));
+    LOG_I(TAG, "Web server started on port %d", WEB_SERVER_PORT);
+}
+
+// 경로별 요청 지연 히스토그램을 붙여 등록
+void WebServerManager::on(const char* path, WebRequestMethodComposite method, ArRequestHandlerFunction handler) {
+    MetricHistogram* latency = new MetricHistogram("peteye_http_request_duration_us", "HTTP handler time by route",
+                                                   HTTP_BUCKETS_US, sizeof(HTTP_BUCKETS_US) / sizeof(HTTP_BUCKETS_US[0]),
+                                                   "route", path);
+    server.on(path, method, [latency, handler](AsyncWebServerRequest* request) {
+        int64_t start = esp_timer_get_time();
+        handler(request);
+        latency->observeSince(start);
+    });
 }
 
-void WebServerManager::handle() {
-    server.handleClient();
+// 페이지 템플릿의 %KEY% 값
+bool WebServerManager::resolvePage(const char* key, size_t keyLen, const String& context, char* out, size_t outSize) {
+    if (TemplateRenderer::keyEquals(key, keyLen, "IP_ADDRESS")) {
+        IPAddress ip = StatusStore::localIP();
+        snprintf(out, outSize, "%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+    } else if (TemplateRenderer::keyEquals(key, keyLen, "STREAM_PORT")) {
+        snprintf(out, outSize, "%u", STREAM_SERVER_PORT);
+    } else if (TemplateRenderer::keyEquals(key, keyLen, "SSID")) {
+        strlcpy(out, context.c_str(), outSize);
+    } else {
+        return false;
+    }
+    return true;
 }
 
-void WebServerManager::handleRoot() {
-    String html = String(INDEX_HTML);
+// PROGMEM 페이지를 청크 전송으로 스트리밍 렌더링
+void WebServerManager::sendTemplate(AsyncWebServerRequest* request, const char* page, const String& context) {
+    std::shared_ptr<TemplateStream> st(new TemplateStream());
+    TemplateRenderer::begin(*st, page, resolvePage, context);
     
-    // 플레이스홀더 교체
-    html.replace("%DEVICE_ID%", sysStatus.deviceId);
-    html.replace("%WIFI_STATUS%", sysStatus.wifiConnected ? "Connected" : "Not Connected");
-    html.replace("%WIFI_CLASS%", sysStatus.wifiConnected ? "online" : "offline");
-    html.replace("%IP_ADDRESS%", sysStatus.localIP.toString());
-    html.replace("%CAM_STATUS%", sysStatus.cameraInitialized ? "Ready" : "Not Initialized");
-    html.replace("%CAM_CLASS%", sysStatus.cameraInitialized ? "online" : "offline");
-    html.replace("%TEMPERATURE%", String(sysStatus.currentTemp, 1) + "°C");
+    AsyncWebServerResponse* response = request->beginChunkedResponse("text/html",
+        [st](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+            return TemplateRenderer::fill(*st, buffer, maxLen);
+        });
+    request->send(response);
+}
+
+// 빌드 시 gzip 한 정적 페이지 - ETag가 같으면 본문 없이 304
+// gzip을 받지 않는 클라이언트에는 원본 PROGMEM 페이지를 보냄 (캐시 검증 없음)
+void WebServerManager::sendStaticPage(AsyncWebServerRequest* request, const uint8_t* gz, size_t gzLen,
+                                      const char* etag, const char* plain) {
+    if (request->hasHeader("If-None-Match") && request->header("If-None-Match") == etag) {
+        AsyncWebServerResponse* response = request->beginResponse(304);
+        response->addHeader("ETag", etag);
+        response->addHeader("Cache-Control", "no-cache");
+        request->send(response);
+        return;
+    }
     
-    server.send(200, "text/html", html);
+    AsyncWebServerResponse* response;
+    if (request->header("Accept-Encoding").indexOf("gzip") >= 0) {
+        response = request->beginResponse_P(200, "text/html", gz, gzLen);
+        response->addHeader("Content-Encoding", "gzip");
+        response->addHeader("ETag", etag);  // 강한 ETag는 gzip 표현에만 붙임
+    } else {
+        response = request->beginResponse_P(200, "text/html", plain);
+    }
+    response->addHeader("Cache-Control", "no-cache");  // 매번 재검증하되 변경 없으면 304
+    response->addHeader("Vary", "Accept-Encoding");
+    request->send(response);
 }
 
-void WebServerManager::handleDebugPage() {
-    server.send(200, "text/html", DEBUG_HTML);
+void WebServerManager::handleRoot(AsyncWebServerRequest* request) {
+    sendStaticPage(request, INDEX_HTML_GZ, INDEX_HTML_GZ_LEN, INDEX_HTML_ETAG, INDEX_HTML);
 }
 
-void WebServerManager::handleScan() {
-    String response = WiFiManager::scanNetworks();
-    server.send(200, "application/json", response);
+void WebServerManager::handleDebugPage(AsyncWebServerRequest* request) {
+    sendStaticPage(request, DEBUG_HTML_GZ, DEBUG_HTML_GZ_LEN, DEBUG_HTML_ETAG, DEBUG_HTML);
 }
 
-void WebServerManager::handleSave() {
-    String ssid = server.arg("ssid");
-    String password = server.arg("password");
+void WebServerManager::handleScan(AsyncWebServerRequest* request) {
+    // 캐시된 결과를 바로 응답 - 오래됐으면 백그라운드 스캔만 요청하고 갱신분은 다음 조회에서
+    WiFiManager::requestScanIfStale();
+    
+    JsonDocument doc;
+    WiFiManager::getScanResults(doc.to<JsonObject>());
+    sendDocument(request, doc);
+}
+
+void WebServerManager::handleSave(AsyncWebServerRequest* request) {
+    String ssid = request->arg("ssid");
+    String password = request->arg("password");
     
     if (ssid.length() == 0) {
-        server.send(400, "text/html", "<html><body><h2>Error: SSID cannot be empty</h2><a href='/'>Go Back</a></body></html>");
+        request->send(400, "text/html", "<html><body><h2>Error: SSID cannot be empty</h2><a href='/'>Go Back</a></body></html>");
         return;
     }
     
-    DebugSystem::log("Saving WiFi credentials: " + ssid);
+    LOG_I(TAG, "Saving WiFi credentials: %s", ssid.c_str());
     WiFiManager::saveCredentials(ssid.c_str(), password.c_str());
     
-    String html = "<html><head><meta charset='utf-8'></head>";
-    html += "<body style='font-family: Arial; text-align: center; padding: 50px;'>";
-    html += "<h2>✅ Configuration Saved!</h2>";
-    html += "<p>Device will restart and connect to: <strong>" + ssid + "</strong></p>";
-    html += "<p>After restart:</p>";
-    html += "<ol style='text-align: left; display: inline-block;'>";
-    html += "<li>Connect your device to the same WiFi network</li>";
-    html += "<li>Access PetEye at: <strong>http://peteye.local</strong></li>";
-    html += "<li>Or check Serial Monitor for IP address</li>";
-    html += "</ol>";
-    html += "<p>Restarting in 5 seconds...</p>";
-    html += "</body></html>";
-    
-    server.send(200, "text/html", html);
-    
-    delay(2000);
-    ESP.restart();
+    sendTemplate(request, SAVED_HTML, ssid);
+    
+    // 응답이 나간 뒤 작업 태스크에서 재시작
+    WebJobs::submit("restart", runRestart);
 }
 
-void WebServerManager::handleStream() {
-    if (!sysStatus.cameraInitialized) {
-        server.send(503, "text/plain", "Camera not initialized");
+void WebServerManager::handleStream(AsyncWebServerRequest* request) {
+    if (!StatusStore::cameraInitialized()) {
+        request->send(503, "text/plain", "Camera not initialized");
         return;
     }
     
-    String html = "<html><body style='text-align:center;'>";
-    html += "<h1>PetEye Camera Stream</h1>";
-    html += "<img src='http://" + sysStatus.localIP.toString() + ":81/stream' style='width:100%; max-width:640px;'/>";
-    html += "<br><a href='/'>Back to Configuration</a>";
-    html += "</body></html>";
-    
-    server.send(200, "text/html", html);
+    sendTemplate(request, STREAM_HTML);
 }
 
-void WebServerManager::handleAPIDebug() {
-    server.send(200, "text/plain", DebugSystem::getLog());
+void WebServerManager::handleAPIDebug(AsyncWebServerRequest* request) {
+    // 로그 링을 한 줄씩 읽어 청크로 전송 (전체 로그 String을 만들지 않음)
+    std::shared_ptr<DebugReader> reader(new DebugReader());
+    DebugSystem::beginRead(*reader);
+    
+    AsyncWebServerResponse* response = request->beginChunkedResponse("text/plain",
+        [reader](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+            return DebugSystem::read(*reader, buffer, maxLen);
+        });
+    request->send(response);
 }
 
-void WebServerManager::handleAPIStatus() {
-    JsonDocument doc;  // ArduinoJson 7.x 문법
+void WebServerManager::buildStatusDocument(JsonDocument& doc) {
+    // 한 번에 복사한 스냅샷으로 - 온도/프로브/연결 상태가 서로 어긋나지 않음
+    SystemStatus status;
+    StatusStore::read(status);
+    
+    doc["deviceId"] = StatusStore::deviceId();
+    doc["ip"] = IPAddress(status.localIP).toString();
     doc["freeHeap"] = ESP.getFreeHeap();
     doc["uptime"] = millis() / 1000;
     doc["rssi"] = WiFi.RSSI();
-    doc["temperature"] = sysStatus.currentTemp;
-    doc["wifiConnected"] = sysStatus.wifiConnected;
-    doc["cameraReady"] = sysStatus.cameraInitialized;
+    doc["temperature"] = status.currentTemp;
+    JsonArray probes = doc["probes"].to<JsonArray>();
+    for (uint8_t i = 0; i < status.tempProbeCount; i++) {
+        probes.add(status.probeTemps[i]);
+    }
+    doc["wifiConnected"] = status.wifiConnected;
+    doc["cameraReady"] = status.cameraInitialized;
+    AnomalyDetector::getState(doc["anomaly"].to<JsonObject>());
+}
+
+// Accept 헤더에 따라 JSON 또는 MessagePack으로 응답 스트림에 바로 인코딩
+// (비동기 서버는 응답을 나중에 보내므로 공용 버퍼를 쓸 수 없음)
+void WebServerManager::sendDocument(AsyncWebServerRequest* request, const JsonDocument& doc) {
+    WireFormat format = WireCodec::fromAccept(request->header("Accept"));
+    AsyncResponseStream* response = request->beginResponseStream(WireCodec::contentType(format));
+    WireCodec::write(doc, format, *response);
+    request->send(response);
+}
+
+void WebServerManager::sendJobAccepted(AsyncWebServerRequest* request, uint32_t jobId) {
+    if (jobId == 0) {
+        request->send(503, "text/plain", "Job queue full");
+        return;
+    }
+    
+    String poll = "/api/job?id=" + String(jobId);
+    JsonDocument doc;
+    doc["job"] = jobId;
+    doc["status"] = "queued";
+    doc["poll"] = poll;
+    
+    AsyncResponseStream* response = request->beginResponseStream("application/json");
+    response->setCode(202);
+    response->addHeader("Location", poll);
+    serializeJson(doc, *response);
+    request->send(response);
+}
+
+void WebServerManager::handleAPIStatus(AsyncWebServerRequest* request) {
+    JsonDocument doc;  // ArduinoJson 7.x 문법
+    buildStatusDocument(doc);
+    sendDocument(request, doc);
+}
+
+void WebServerManager::handleAPIJob(AsyncWebServerRequest* request) {
+    JsonDocument doc;
+    if (!WebJobs::getJob(request->arg("id").toInt(), doc.to<JsonObject>())) {
+        request->send(404, "text/plain", "Unknown job");
+        return;
+    }
+    sendDocument(request, doc);
+}
+
+void WebServerManager::handleAPIStreamStats(AsyncWebServerRequest* request) {
+    JsonDocument doc;
+    StreamServer::getStats(doc.to<JsonObject>());
+    
+    String response;
+    serializeJson(doc, response);
+    request->send(200, "application/json", response);
+}
+
+void WebServerManager::handleAPIEventStats(AsyncWebServerRequest* request) {
+    JsonDocument doc;
+    EventStream::getStats(doc.to<JsonObject>());
+    
+    String response;
+    serializeJson(doc, response);
+    request->send(200, "application/json", response);
+}
+
+void WebServerManager::handleAPIUploadStats(AsyncWebServerRequest* request) {
+    JsonDocument doc;
+    UploadPipeline::getStats(doc.to<JsonObject>());
+    
+    String response;
+    serializeJson(doc, response);
+    request->send(200, "application/json", response);
+}
+
+void WebServerManager::handleAPITelemetryStats(AsyncWebServerRequest* request) {
+    JsonDocument doc;
+    TelemetryBatcher::getStats(doc.to<JsonObject>());
     
     String response;
     serializeJson(doc, response);
-    server.send(200, "application/json", response);
+    request->send(200, "application/json", response);
+}
+
+void WebServerManager::handleAPIBackendStats(AsyncWebServerRequest* request) {
+    JsonDocument doc;
+    BackendClient::getStats(doc.to<JsonObject>());
+    
+    String response;
+    serializeJson(doc, response);
+    request->send(200, "application/json", response);
+}
+
+void WebServerManager::handleAPIOfflineStats(AsyncWebServerRequest* request) {
+    JsonDocument doc;
+    OfflineQueue::getStats(doc.to<JsonObject>());
+    
+    String response;
+    serializeJson(doc, response);
+    request->send(200, "application/json", response);
+}
+
+void WebServerManager::handleAPIWiFiStats(AsyncWebServerRequest* request) {
+    JsonDocument doc;
+    WiFiManager::getStats(doc.to<JsonObject>());
+    sendDocument(request, doc);
+}
+
+// /api/history 청크 응답 상태 - 응답 객체가 살아 있는 동안 filler 람다가 보유
+struct HistoryStream {
+    HistoryResolution res;
+    uint32_t from;
+    uint32_t to;
+    uint32_t now;
+    uint32_t cursor;
+    HistoryPoint points[HISTORY_CHUNK_POINTS];
+    size_t count;
+    size_t next;
+    bool started;
+    bool first;
+    bool finished;
+    char pending[80];
+    size_t pendingLen;
+    size_t pendingPos;   // pending 중 이미 보낸 바이트
+};
+
+// 다음 조각(머리, 점 하나, 끝)을 pending에 만들고 버퍼가 허락하는 만큼 복사
+// 조각이 남은 공간보다 커도 잘라서 보냄 - 0을 반환하면 서버가 응답 끝으로 처리
+static size_t fillHistory(HistoryStream& st, uint8_t* buffer, size_t maxLen) {
+    if (maxLen == 0) {
+        return RESPONSE_TRY_AGAIN;
+    }
+    
+    size_t len = 0;
+    for (;;) {
+        if (st.pendingPos < st.pendingLen) {
+            size_t n = min(st.pendingLen - st.pendingPos, maxLen - len);
+            memcpy(buffer + len, st.pending + st.pendingPos, n);
+            st.pendingPos += n;
+            len += n;
+            if (st.pendingPos < st.pendingLen) {
+                break;
+            }
+        }
+        st.pendingLen = 0;
+        st.pendingPos = 0;
+        if (st.finished || len == maxLen) {
+            break;
+        }
+        
+        if (!st.started) {
+            st.pendingLen = snprintf(st.pending, sizeof(st.pending), "{\"res\":\"%s\",\"now\":%u,\"points\":[",
+                                     TempHistory::resolutionName(st.res), st.now);
+            st.started = true;
+            st.first = true;
+            continue;
+        }
+        
+        if (st.next == st.count) {
+            st.count = TempHistory::readPoints(st.res, st.from, st.to, st.cursor, st.points, HISTORY_CHUNK_POINTS);
+            st.next = 0;
+            if (st.count == 0) {
+                st.pendingLen = snprintf(st.pending, sizeof(st.pending), "]}");
+                st.finished = true;
+                continue;
+            }
+        }
+        
+        const HistoryPoint& p = st.points[st.next++];
+        const char* sep = st.first ? "" : ",";
+        if (st.res == HISTORY_RAW) {
+            st.pendingLen = snprintf(st.pending, sizeof(st.pending), "%s[%u,%.2f]", sep, p.t, p.avg);
+        } else {
+            st.pendingLen = snprintf(st.pending, sizeof(st.pending), "%s[%u,%.2f,%.2f,%.2f,%u]",
+                                     sep, p.t, p.min, p.max, p.avg, p.count);
+        }
+        st.first = false;
+    }
+    return len;
+}
+
+void WebServerManager::handleAPIHistory(AsyncWebServerRequest* request) {
+    HistoryResolution res;
+    if (!TempHistory::parseResolution(request->arg("res"), res)) {
+        request->send(400, "text/plain", "res must be raw, 1m, 15m or 1h");
+        return;
+    }
+    if (!TempHistory::isReady()) {
+        request->send(503, "text/plain", "History not available");
+        return;
+    }
+    
+    std::shared_ptr<HistoryStream> st(new HistoryStream());
+    st->res = res;
+    st->now = millis() / 1000;
+    st->from = request->hasArg("from") ? request->arg("from").toInt() : 0;
+    st->to = request->hasArg("to") ? request->arg("to").toInt() : st->now;
+    
+    // 청크 전송 - 전체 응답을 메모리에 만들지 않고 TCP 버퍼가 빌 때마다 조금씩 채움
+    AsyncWebServerResponse* response = request->beginChunkedResponse("application/json",
+        [st](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+            return fillHistory(*st, buffer, maxLen);
+        });
+    request->send(response);
 }
 
-void WebServerManager::handleAPIClear() {
+void WebServerManager::handleAPIClear(AsyncWebServerRequest* request) {
     DebugSystem::clear();
-    server.send(200, "text/plain", "OK");
+    request->send(200, "text/plain", "OK");
 }
 
-void WebServerManager::handleAPITestCamera() {
-    DebugSystem::log("Testing camera...");
+void WebServerManager::handleAPITestCamera(AsyncWebServerRequest* request) {
+    // 카메라/센서 작업은 sensors 태스크에서 실행 (센서 상태 기계와 버스를 다투지 않도록)
+    sendJobAccepted(request, WebJobs::submit("test_camera", runTestCamera, false, WEB_JOB_SENSORS));
+}
+
+String WebServerManager::runTestCamera() {
+    LOG_I(TAG, "Testing camera...");
     bool result = CameraManager::testCapture();
-    server.send(200, "text/plain", result ? "OK" : "FAILED");
+    return result ? "OK" : "FAILED";
+}
+
+void WebServerManager::handleAPITestTemperature(AsyncWebServerRequest* request) {
+    // 몇 초씩 블로킹하므로 작업 태스크에서 - sensors 태스크의 측정/스케줄러 틱을 멈추지 않음
+    sendJobAccepted(request, WebJobs::submit("test_temperature", runTestTemperature));
+}
+
+String WebServerManager::runTestTemperature() {
+    // 진행 중인 읽기 주기가 끝날 때까지 기다렸다가 버스를 독점 (그동안 읽기 주기는 건너뜀)
+    if (!SensorManager::lockBus(pdMS_TO_TICKS(TEMP_BUS_WAIT))) {
+        return "FAILED: OneWire bus busy";
+    }
+    String result = testTemperatureBus();
+    SensorManager::unlockBus();
+    return result;
 }
 
-void WebServerManager::handleAPITestTemperature() {
-    DebugSystem::log("=== Temperature Sensor Diagnostic Test ===");
+String WebServerManager::testTemperatureBus() {
+    String result;
+    LOG_I(TAG, "=== Temperature Sensor Diagnostic Test ===");
     
     // 1. GPIO 핀 상태 체크
-    DebugSystem::log("1. Checking GPIO" + String(TEMP_SENSOR_PIN) + " state...");
+    LOG_D(TAG, "1. Checking GPIO%d state...", TEMP_SENSOR_PIN);
     pinMode(TEMP_SENSOR_PIN, INPUT_PULLUP);
     delay(10);
-    int pinState = digitalRead(TEMP_SENSOR_PIN);
-    DebugSystem::log("   Pin state (pullup): " + String(pinState ? "HIGH" : "LOW"));
+    LOG_I(TAG, "   Pin state (pullup): %s", digitalRead(TEMP_SENSOR_PIN) ? "HIGH" : "LOW");
     
     // 2. OneWire 버스 체크
-    DebugSystem::log("2. Testing OneWire bus...");
+    LOG_D(TAG, "2. Testing OneWire bus...");
     OneWire testWire(TEMP_SENSOR_PIN);
-    uint8_t resetResult = testWire.reset();
-    DebugSystem::log("   Bus reset: " + String(resetResult ? "SUCCESS" : "FAILED"));
+    LOG_I(TAG, "   Bus reset: %s", testWire.reset() ? "SUCCESS" : "FAILED");
     
     // 3. 장치 검색
-    DebugSystem::log("3. Scanning for devices...");
+    LOG_D(TAG, "3. Scanning for devices...");
     uint8_t address[8];
     int count = 0;
     testWire.reset_search();
     
     while (testWire.search(address)) {
         count++;
-        String addr = "   Device " + String(count) + ": ";
-        for (int i = 0; i < 8; i++) {
-            if (address[i] < 16) addr += "0";
-            addr += String(address[i], HEX);
-            if (i < 7) addr += ":";
-        }
-        DebugSystem::log(addr);
+        LOG_D(TAG, "   Device %d: %02x:%02x:%02x:%02x:%02x:%02x:%02x:%02x", count,
+              address[0], address[1], address[2], address[3], address[4], address[5], address[6], address[7]);
         
         // CRC 체크
         if (OneWire::crc8(address, 7) == address[7]) {
-            DebugSystem::log("   └─ CRC: OK, Type: 0x" + String(address[0], HEX));
+            LOG_D(TAG, "   └─ CRC: OK, Type: 0x%x", address[0]);
         } else {
-            DebugSystem::log("   └─ CRC: FAILED!");
+            LOG_W(TAG, "   └─ CRC: FAILED!");
         }
     }
     
     if (count == 0) {
-        DebugSystem::log("   ❌ No devices found!");
+        LOG_E(TAG, "   ❌ No devices found!");
         
         // 4. 추가 하드웨어 체크
-        DebugSystem::log("4. Hardware connection check:");
-        DebugSystem::log("   - Check 4.7kΩ pullup resistor between data and VCC");
-        DebugSystem::log("   - Verify JST connector wiring:");
-        DebugSystem::log("     • Red = VCC (3.3V)");
-        DebugSystem::log("     • Yellow = Data (GPIO" + String(TEMP_SENSOR_PIN) + ")");
-        DebugSystem::log("     • Black = GND");
+        LOG_D(TAG, "4. Hardware connection check:");
+        LOG_D(TAG, "   - Check 4.7kΩ pullup resistor between data and VCC");
+        LOG_D(TAG, "   - Verify JST connector wiring:");
+        LOG_D(TAG, "     • Red = VCC (3.3V)");
+        LOG_D(TAG, "     • Yellow = Data (GPIO%d)", TEMP_SENSOR_PIN);
+        LOG_D(TAG, "     • Black = GND");
         
         // 5. 핀 토글 테스트
-        DebugSystem::log("5. Pin toggle test...");
+        LOG_D(TAG, "5. Pin toggle test...");
         pinMode(TEMP_SENSOR_PIN, OUTPUT);
         int toggleCount = 0;
         for (int i = 0; i < 10; i++) {
@@ -204,12 +512,12 @@ void WebServerManager::handleAPITestTemperature() {
             }
         }
         pinMode(TEMP_SENSOR_PIN, INPUT_PULLUP);
-        DebugSystem::log("   Toggle success rate: " + String(toggleCount * 10) + "%");
+        LOG_I(TAG, "   Toggle success rate: %d%%", toggleCount * 10);
         
-        server.send(200, "text/plain", "FAILED: No sensor found. Check debug log.");
+        result = "FAILED: No sensor found. Check debug log.";
     } else {
         // 센서를 찾은 경우 온도 읽기 시도
-        DebugSystem::log("4. Attempting temperature read...");
+        LOG_D(TAG, "4. Attempting temperature read...");
         
         // DallasTemperature 라이브러리 재초기화
         DallasTemperature sensors(&testWire);
@@ -219,90 +527,248 @@ void WebServerManager::handleAPITestTemperature() {
         sensors.setResolution(12);
         
         // 온도 변환 요청
-        DebugSystem::log("   Requesting temperature conversion...");
+        LOG_D(TAG, "   Requesting temperature conversion...");
         sensors.requestTemperatures();
         
         // 충분한 변환 시간 대기
-        DebugSystem::log("   Waiting 750ms for conversion...");
+        LOG_D(TAG, "   Waiting 750ms for conversion...");
         delay(750);
         
         // 온도 읽기
         float temp = sensors.getTempCByIndex(0);
-        DebugSystem::log("   Raw reading: " + String(temp, 2) + "°C");
+        LOG_D(TAG, "   Raw reading: %.2f°C", temp);
         
         if (temp != DEVICE_DISCONNECTED_C && temp != 85.0) {
-            sysStatus.currentTemp = temp;
-            DebugSystem::log("   ✅ Temperature: " + String(temp, 2) + "°C");
-            server.send(200, "text/plain", "OK: " + String(temp, 2) + "°C");
+            StatusStore::setTemperature(temp, millis());
+            LOG_I(TAG, "   ✅ Temperature: %.2f°C", temp);
+            result = "OK: " + String(temp, 2) + "°C";
         } else if (temp == 85.0) {
-            DebugSystem::log("   ⚠️ Got 85°C - Power-on reset value, retrying...");
+            LOG_W(TAG, "   ⚠️ Got 85°C - Power-on reset value, retrying...");
             delay(100);
             sensors.requestTemperatures();
             delay(1000);
             temp = sensors.getTempCByIndex(0);
-            DebugSystem::log("   Retry result: " + String(temp, 2) + "°C");
+            LOG_I(TAG, "   Retry result: %.2f°C", temp);
             
             if (temp != DEVICE_DISCONNECTED_C && temp != 85.0) {
-                server.send(200, "text/plain", "OK after retry: " + String(temp, 2) + "°C");
+                result = "OK after retry: " + String(temp, 2) + "°C";
             } else {
-                server.send(200, "text/plain", "FAILED: Sensor power issue (85°C)");
+                result = "FAILED: Sensor power issue (85°C)";
             }
         } else {
-            DebugSystem::log("   ❌ Read failed (got -127°C)");
-            DebugSystem::log("   Possible causes:");
-            DebugSystem::log("   - Insufficient conversion time");
-            DebugSystem::log("   - Power supply issue");
-            DebugSystem::log("   - Parasite power mode conflict");
-            server.send(200, "text/plain", "FAILED: Sensor found but can't read (-127°C)");
+            LOG_E(TAG, "   ❌ Read failed (got -127°C)");
+            LOG_D(TAG, "   Possible causes:");
+            LOG_D(TAG, "   - Insufficient conversion time");
+            LOG_D(TAG, "   - Power supply issue");
+            LOG_D(TAG, "   - Parasite power mode conflict");
+            result = "FAILED: Sensor found but can't read (-127°C)";
         }
     }
     
-    DebugSystem::log("=== End Diagnostic Test ===");
+    LOG_I(TAG, "=== End Diagnostic Test ===");
+    return result;
+}
+
+void WebServerManager::buildTestAPIDocument(JsonDocument& doc) {
+    doc["deviceId"] = StatusStore::deviceId();
+    doc["timestamp"] = millis();
+}
+
+void WebServerManager::handleAPITestAPI(AsyncWebServerRequest* request) {
+    sendJobAccepted(request, WebJobs::submit("test_api", runTestAPI));
 }
 
-void WebServerManager::handleAPITestAPI() {
-    DebugSystem::log("Testing API connection...");
+String WebServerManager::runTestAPI() {
+    LOG_I(TAG, "Testing API connection...");
     
-    if (!sysStatus.wifiConnected) {
-        DebugSystem::log("Cannot test API - WiFi not connected");
-        server.send(200, "text/plain", "WiFi not connected");
-        return;
+    if (!StatusStore::wifiConnected()) {
+        LOG_I(TAG, "Cannot test API - WiFi not connected");
+        return "WiFi not connected";
     }
     
-    HTTPClient http;
-    http.begin(String(API_BASE_URL) + "/test");
-    http.addHeader("Content-Type", "application/json");
-    
     JsonDocument doc;  // ArduinoJson 7.x 문법
-    doc["deviceId"] = sysStatus.deviceId;
-    doc["timestamp"] = millis();
+    buildTestAPIDocument(doc);
     
-    String payload;
-    serializeJson(doc, payload);
+    WireFormat format = WireCodec::uploadFormat();
+    uint8_t payload[128];
+    size_t len = WireCodec::encode(doc, format, payload, sizeof(payload));
     
-    int httpCode = http.POST(payload);
+    String response;
+    int httpCode = BackendClient::post("/test", WireCodec::contentType(format), payload, len,
+                                       API_TIMEOUT, nullptr, 0, &response);
     
     if (httpCode > 0) {
-        DebugSystem::log("API test response code: " + String(httpCode));
+        LOG_I(TAG, "API test response code: %d (%s)", httpCode, WireCodec::name(format));
         if (httpCode == HTTP_CODE_OK) {
-            String response = http.getString();
-            DebugSystem::log("API response: " + response);
+            LOG_D(TAG, "API response: %s", response.c_str());
+        } else if (httpCode == 415 && format == WIRE_MSGPACK) {
+            WireCodec::markMsgPackRejected();
         }
     } else {
-        DebugSystem::log("API test failed: " + http.errorToString(httpCode));
+        LOG_E(TAG, "API test failed: %s", HTTPClient::errorToString(httpCode).c_str());
+        return "FAILED: " + HTTPClient::errorToString(httpCode);
     }
     
-    http.end();
-    server.send(200, "text/plain", "OK");
+    return "HTTP " + String(httpCode);
+}
+
+void WebServerManager::handleAPITestWire(AsyncWebServerRequest* request) {
+    sendJobAccepted(request, WebJobs::submit("test_wire", runTestWire, true));
+}
+
+// 실제 기기 문서들로 JSON / MessagePack 인코딩 시간과 크기 비교
+String WebServerManager::runTestWire() {
+    JsonDocument docs[3];
+    const char* names[3] = {"status", "telemetryBatch", "testApi"};
+    buildStatusDocument(docs[0]);
+    TelemetryBatcher::buildDocument(docs[1]);
+    buildTestAPIDocument(docs[2]);
+    
+    JsonDocument result;
+    result["iterations"] = WIRE_BENCH_ITERATIONS;
+    result["telemetryReadings"] = TelemetryBatcher::pending();
+    result["uploadFormat"] = WireCodec::name(WireCodec::uploadFormat());
+    
+    for (int d = 0; d < 3; d++) {
+        JsonObject entry = result[names[d]].to<JsonObject>();
+        for (int f = WIRE_JSON; f <= WIRE_MSGPACK; f++) {
+            WireFormat format = (WireFormat)f;
+            JsonObject stats = entry[WireCodec::name(format)].to<JsonObject>();
+            
+            // 업로드 경로와 같이 문서 크기에 맞춘 버퍼로 인코딩 (큰 텔레메트리 배치도 잘리지 않음)
+            size_t capacity = WireCodec::measure(docs[d], format) + 1;
+            uint8_t* buffer = (uint8_t*)malloc(capacity);
+            if (buffer == nullptr) {
+                LOG_E(TAG, "❌ Wire test: no memory for %u byte %s buffer", (unsigned)capacity, names[d]);
+                stats["error"] = "out of memory";
+                continue;
+            }
+            
+            size_t len = 0;
+            unsigned long start = micros();
+            for (int i = 0; i < WIRE_BENCH_ITERATIONS; i++) {
+                len = WireCodec::encode(docs[d], format, buffer, capacity);
+            }
+            unsigned long elapsed = micros() - start;
+            free(buffer);
+            
+            if (len == 0) {
+                LOG_E(TAG, "❌ Wire test: %s encode failed (%s)", names[d], WireCodec::name(format));
+                stats["error"] = "encode failed";
+                continue;
+            }
+            stats["bytes"] = len;
+            stats["encodeUs"] = (float)elapsed / WIRE_BENCH_ITERATIONS;
+        }
+    }
+    
+    String response;
+    serializeJson(result, response);
+    LOG_D(TAG, "Wire format test: %s", response.c_str());
+    return response;
+}
+
+void WebServerManager::handleAPIWire(AsyncWebServerRequest* request) {
+    WireFormat format;
+    if (request->hasArg("upload")) {
+        if (!WireCodec::parse(request->arg("upload"), format)) {
+            request->send(400, "text/plain", "upload must be json or msgpack");
+            return;
+        }
+        WireCodec::setUploadFormat(format);
+    }
+    
+    JsonDocument doc;
+    doc["upload"] = WireCodec::name(WireCodec::uploadFormat());
+    doc["msgpackRejected"] = WireCodec::isMsgPackRejected();
+    sendDocument(request, doc);
+}
+
+// 실행 중 로그 레벨 조회/변경 - 컴파일되지 않은 레벨은 올려도 출력되지 않음
+void WebServerManager::handleAPILogLevel(AsyncWebServerRequest* request) {
+    if (request->method() == HTTP_POST && request->hasArg("level")) {
+        uint8_t level;
+        if (!DebugSystem::parseLevel(request->arg("level"), level)) {
+            request->send(400, "text/plain", "level must be none, error, warn, info, debug or trace");
+            return;
+        }
+        DebugSystem::setLevel(level);
+    }
+    
+    JsonDocument doc;
+    doc["level"] = DebugSystem::levelName(DebugSystem::getLevel());
+    doc["compiled"] = DebugSystem::levelName(LOG_LEVEL);
+    sendDocument(request, doc);
+}
+
+// 태스크 단계별 실행 시간 - POST reset 으로 창과 최악값 초기화
+void WebServerManager::handleAPIProfile(AsyncWebServerRequest* request) {
+    if (request->method() == HTTP_POST && request->hasArg("reset")) {
+        LoopProfiler::reset();
+    }
+    
+    JsonDocument doc;
+    LoopProfiler::getStats(doc.to<JsonObject>());
+    sendDocument(request, doc);
+}
+
+// 태스크별 코어/우선순위/최소 여유 스택/CPU 사용률
+void WebServerManager::handleAPITasks(AsyncWebServerRequest* request) {
+    JsonDocument doc;
+    AppTasks::getStats(doc.to<JsonObject>());
+    sendDocument(request, doc);
+}
+
+// 예약 작업별 주기/지연/초과 - POST job=&interval= 로 주기 변경 (NVS에 저장)
+void WebServerManager::handleAPIScheduler(AsyncWebServerRequest* request) {
+    if (request->method() == HTTP_POST && request->hasArg("job") && request->hasArg("interval")) {
+        long interval = request->arg("interval").toInt();
+        if (interval <= 0 || !Scheduler::setInterval(request->arg("job").c_str(), (uint32_t)interval)) {
+            request->send(400, "text/plain", "unknown periodic job or interval below scheduler tick");
+            return;
+        }
+    }
+    
+    JsonDocument doc;
+    Scheduler::getStats(doc.to<JsonObject>());
+    sendDocument(request, doc);
+}
+
+// Prometheus 스크레이프
+void WebServerManager::handleMetrics(AsyncWebServerRequest* request) {
+    AsyncResponseStream* response = request->beginResponseStream("text/plain; version=0.0.4");
+    Metrics::write(*response);
+    request->send(response);
+}
+
+// 바이너리 로그 링을 프레임 그대로 전송 - tools/log_decode.py 로 해석
+void WebServerManager::handleAPILogRaw(AsyncWebServerRequest* request) {
+    if (!LOG_BINARY) {
+        request->send(404, "text/plain", "Binary logging disabled (build with -DLOG_BINARY=1)");
+        return;
+    }
+    
+    std::shared_ptr<DebugReader> reader(new DebugReader());
+    DebugSystem::beginRead(*reader, true);
+    
+    AsyncWebServerResponse* response = request->beginChunkedResponse("application/octet-stream",
+        [reader](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+            return DebugSystem::read(*reader, buffer, maxLen);
+        });
+    request->send(response);
+}
+
+void WebServerManager::handleAPIReboot(AsyncWebServerRequest* request) {
+    LOG_I(TAG, "System reboot requested");
+    sendJobAccepted(request, WebJobs::submit("restart", runRestart));
 }
 
-void WebServerManager::handleAPIReboot() {
-    DebugSystem::log("System reboot requested");
-    server.send(200, "text/plain", "Rebooting...");
-    delay(1000);
+String WebServerManager::runRestart() {
+    delay(2000);  // 응답이 전송될 시간
     ESP.restart();
+    return "";
 }
 
-void WebServerManager::handleNotFound() {
-    server.send(404, "text/plain", "404: Not Found");
+void WebServerManager::handleNotFound(AsyncWebServerRequest* request) {
+    request->send(404, "text/plain", "404: Not Found");
 }
\ No newline at end of file
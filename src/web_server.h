@@ -1,33 +1,70 @@
 #ifndef WEB_SERVER_H
 #define WEB_SERVER_H
 
-#include <WebServer.h>
+#include <ESPAsyncWebServer.h>
+#include <ArduinoJson.h>
 #include "config.h"
 
+// 비동기 웹 서버 - 핸들러는 AsyncTCP 태스크에서 실행되므로 블로킹 금지
+// 오래 걸리는 일(스캔, 하드웨어 테스트, 백엔드 호출, 재부팅)은 WebJobs로 넘기고 202 + 작업 ID 응답
 class WebServerManager {
 private:
-    static WebServer server;
+    static AsyncWebServer server;
+    
+    static void on(const char* path, WebRequestMethodComposite method, ArRequestHandlerFunction handler);
+    static void buildTestAPIDocument(JsonDocument& doc);
+    static void sendDocument(AsyncWebServerRequest* request, const JsonDocument& doc);
+    static void sendJobAccepted(AsyncWebServerRequest* request, uint32_t jobId);
+    static bool resolvePage(const char* key, size_t keyLen, const String& context, char* out, size_t outSize);
+    static void sendTemplate(AsyncWebServerRequest* request, const char* page, const String& context = String());
+    static void sendStaticPage(AsyncWebServerRequest* request, const uint8_t* gz, size_t gzLen,
+                               const char* etag, const char* plain);
+    
+    // WebJobs에서 실행되는 작업
+    static String runTestCamera();
+    static String runTestTemperature();
+    static String testTemperatureBus();
+    static String runTestAPI();
+    static String runTestWire();
+    static String runRestart();
     
 public:
     static void init();
-    static void handle();
+    static void buildStatusDocument(JsonDocument& doc);  // /api/status 및 이벤트 스트림 공용
     
     // 페이지 핸들러
-    static void handleRoot();
-    static void handleDebugPage();
-    static void handleScan();
-    static void handleSave();
-    static void handleStream();
-    static void handleNotFound();
+    static void handleRoot(AsyncWebServerRequest* request);
+    static void handleDebugPage(AsyncWebServerRequest* request);
+    static void handleScan(AsyncWebServerRequest* request);
+    static void handleSave(AsyncWebServerRequest* request);
+    static void handleStream(AsyncWebServerRequest* request);
+    static void handleNotFound(AsyncWebServerRequest* request);
     
     // API 핸들러
-    static void handleAPIDebug();
-    static void handleAPIStatus();
-    static void handleAPIClear();
-    static void handleAPITestCamera();
-    static void handleAPITestTemperature();
-    static void handleAPITestAPI();
-    static void handleAPIReboot();
+    static void handleAPIDebug(AsyncWebServerRequest* request);
+    static void handleAPIStatus(AsyncWebServerRequest* request);
+    static void handleAPIJob(AsyncWebServerRequest* request);
+    static void handleAPIStreamStats(AsyncWebServerRequest* request);
+    static void handleAPIEventStats(AsyncWebServerRequest* request);
+    static void handleAPIUploadStats(AsyncWebServerRequest* request);
+    static void handleAPITelemetryStats(AsyncWebServerRequest* request);
+    static void handleAPIBackendStats(AsyncWebServerRequest* request);
+    static void handleAPIOfflineStats(AsyncWebServerRequest* request);
+    static void handleAPIWiFiStats(AsyncWebServerRequest* request);
+    static void handleAPIHistory(AsyncWebServerRequest* request);
+    static void handleAPIClear(AsyncWebServerRequest* request);
+    static void handleAPITestCamera(AsyncWebServerRequest* request);
+    static void handleAPITestTemperature(AsyncWebServerRequest* request);
+    static void handleAPITestAPI(AsyncWebServerRequest* request);
+    static void handleAPITestWire(AsyncWebServerRequest* request);
+    static void handleAPIWire(AsyncWebServerRequest* request);
+    static void handleAPILogLevel(AsyncWebServerRequest* request);
+    static void handleAPILogRaw(AsyncWebServerRequest* request);
+    static void handleAPIProfile(AsyncWebServerRequest* request);
+    static void handleAPITasks(AsyncWebServerRequest* request);
+    static void handleAPIScheduler(AsyncWebServerRequest* request);
+    static void handleMetrics(AsyncWebServerRequest* request);
+    static void handleAPIReboot(AsyncWebServerRequest* request);
 };
 
-#endif // WEB_SERVER_H
\ No newline at end of file
+#endif // WEB_SERVER_H
@@ -1,81 +1,225 @@
 #include "wifi_manager.h"
-#include <ArduinoJson.h>
+#include "metrics.h"
+#include "app_tasks.h"
+#include "status_store.h"
+
+static constexpr char TAG[] = "wifi";
+
+static MetricCounter reconnects("peteye_wifi_reconnects_total", "Reconnect attempts after losing WiFi");
+static MetricCounter connectFailures("peteye_wifi_connect_failures_total", "Connection attempts that timed out or were rejected");
+static MetricGauge connectTime("peteye_wifi_connect_ms", "Time from WiFi.begin() to IP for the last connection");
 
 WiFiCredentials WiFiManager::credentials;
 Preferences WiFiManager::preferences;
+WiFiState WiFiManager::state = WIFI_STATE_AP_ONLY;
+unsigned long WiFiManager::stateSince = 0;
+unsigned long WiFiManager::backoffMs = 0;
+uint32_t WiFiManager::failures = 0;
+uint32_t WiFiManager::attempts = 0;
+bool WiFiManager::everConnected = false;
+bool WiFiManager::fallbackAP = false;
+volatile bool WiFiManager::linkUp = false;
+volatile uint32_t WiFiManager::disconnectEvents = 0;
+volatile uint8_t WiFiManager::lastReason = 0;
+uint32_t WiFiManager::seenDisconnects = 0;
+WiFiFastJoin WiFiManager::fastJoin;
+bool WiFiManager::tryFastJoin = true;
+bool WiFiManager::attemptFast = false;
+bool WiFiManager::staticIP = false;
+uint32_t WiFiManager::fastJoins = 0;
+uint32_t WiFiManager::fastJoinFallbacks = 0;
+uint32_t WiFiManager::lastConnectMs = 0;
+uint32_t WiFiManager::bootConnectMs = 0;
+WiFiScanEntry WiFiManager::scanResults[WIFI_SCAN_MAX_RESULTS];
+uint8_t WiFiManager::scanCount = 0;
+unsigned long WiFiManager::scanTime = 0;
+volatile bool WiFiManager::scanRequested = false;
+volatile bool WiFiManager::scanRunning = false;
+portMUX_TYPE WiFiManager::scanMux = portMUX_INITIALIZER_UNLOCKED;
 
 void WiFiManager::init() {
     loadCredentials();
+    WiFi.onEvent(onEvent);
     
-    // WiFi 연결 시도
     if (credentials.valid) {
+        // 연결은 백그라운드로 진행 - 결과는 update()가 이벤트로 확인
         Serial.println("Found saved WiFi credentials");
-        if (!connect()) {
-            // 연결 실패 시 자격증명 삭제
-            clearCredentials();
-            DebugSystem::log("Cleared invalid WiFi credentials");
-            startAP();
-        }
+        WiFi.setHostname(DEVICE_NAME);
+        WiFi.mode(WIFI_STA);
+        WiFi.setAutoReconnect(false);  // 재시도 시점은 백오프가 결정
+        beginConnect();
     } else {
-        DebugSystem::log("No saved credentials, starting AP mode");
+        LOG_I(TAG, "No saved credentials, starting AP mode");
         startAP();
+        setState(WIFI_STATE_AP_ONLY);
     }
     
     // mDNS 시작
     if (MDNS.begin(DEVICE_NAME)) {
-        DebugSystem::log("mDNS started: http://" + String(DEVICE_NAME) + ".local");
+        LOG_I(TAG, "mDNS started: http://%s.local", DEVICE_NAME);
         MDNS.addService("http", "tcp", WEB_SERVER_PORT);
     }
 }
 
-bool WiFiManager::connect() {
-    if (!credentials.valid) {
-        return false;
+// WiFi 이벤트 태스크(코어 0)에서 호출 - 플래그만 기록
+void WiFiManager::onEvent(WiFiEvent_t event, WiFiEventInfo_t info) {
+    switch (event) {
+        case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+            linkUp = true;
+            break;
+        case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+            linkUp = false;
+            lastReason = info.wifi_sta_disconnected.reason;
+            disconnectEvents++;
+            break;
+        case ARDUINO_EVENT_WIFI_STA_LOST_IP:
+            linkUp = false;
+            disconnectEvents++;
+            break;
+        default:
+            break;
     }
+}
+
+void WiFiManager::setState(WiFiState next) {
+    state = next;
+    stateSince = millis();
+}
+
+void WiFiManager::beginConnect() {
+    attempts++;
+    attemptFast = fastJoin.valid && tryFastJoin;
     
-    DebugSystem::log("Connecting to WiFi: " + String(credentials.ssid));
+    // 이전 시도의 끊김 이벤트는 무시
+    seenDisconnects = disconnectEvents;
+    linkUp = false;
     
-    // 기존 연결 종료
-    WiFi.disconnect(true);
-    delay(100);
+    if (attemptFast) {
+        // 마지막 AP/채널로 바로 접속 - 전체 채널 스캔 생략
+        LOG_I(TAG, "Fast join to %s (ch %d, %02X:%02X:%02X:%02X:%02X:%02X)", credentials.ssid, fastJoin.channel,
+              fastJoin.bssid[0], fastJoin.bssid[1], fastJoin.bssid[2],
+              fastJoin.bssid[3], fastJoin.bssid[4], fastJoin.bssid[5]);
+        if (WIFI_FAST_REUSE_IP) {
+            WiFi.config(IPAddress(fastJoin.ip), IPAddress(fastJoin.gateway),
+                        IPAddress(fastJoin.subnet), IPAddress(fastJoin.dns));
+            staticIP = true;
+        }
+        WiFi.begin(credentials.ssid, credentials.password, fastJoin.channel, fastJoin.bssid);
+    } else {
+        LOG_I(TAG, "Connecting to WiFi: %s (attempt %u)", credentials.ssid, failures + 1);
+        if (staticIP) {
+            WiFi.config(IPAddress(), IPAddress(), IPAddress());  // DHCP로 복귀
+            staticIP = false;
+        }
+        WiFi.begin(credentials.ssid, credentials.password);
+    }
+    setState(WIFI_STATE_CONNECTING);
+}
+
+void WiFiManager::onConnected() {
+    lastConnectMs = millis() - stateSince;
+    connectTime.set(lastConnectMs);
+    if (!everConnected) {
+        bootConnectMs = millis();
+    }
+    if (attemptFast) {
+        fastJoins++;
+    }
     
-    WiFi.mode(WIFI_STA);
-    WiFi.setHostname(DEVICE_NAME);
-    WiFi.begin(credentials.ssid, credentials.password);
+    failures = 0;
+    everConnected = true;
+    tryFastJoin = true;
+    StatusStore::setWiFi(true, WiFi.localIP());
+    AppTasks::setBits(APP_EVENT_WIFI_UP | APP_EVENT_CAPTURE);  // 연결 직후 첫 스냅샷은 바로
+    setState(WIFI_STATE_CONNECTED);
+    saveFastJoin();
     
-    // 연결 대기 (20초)
-    int attempts = 0;
-    while (WiFi.status() != WL_CONNECTED && attempts < 40) {
-        delay(500);
-        Serial.print(".");
-        attempts++;
-        
-        if (attempts % 10 == 0) {
-            Serial.print(" [Status: ");
-            Serial.print(WiFi.status());
-            Serial.print("] ");
-        }
+    LOG_I(TAG, "✅ WiFi connected in %u ms (%s)", lastConnectMs, attemptFast ? "fast join" : "full scan");
+    LOG_I(TAG, "IP: %s", WiFi.localIP().toString().c_str());
+    LOG_I(TAG, "RSSI: %d dBm", WiFi.RSSI());
+}
+
+void WiFiManager::onFailed(const char* why) {
+    // 저장된 AP가 없어졌거나 채널이 바뀜 - 기다리지 않고 전체 스캔으로 재시도
+    if (attemptFast) {
+        LOG_W(TAG, "Fast join failed (%s, reason %u) - falling back to full scan", why, lastReason);
+        fastJoinFallbacks++;
+        tryFastJoin = false;
+        WiFi.disconnect();
+        backoffMs = 250;  // disconnect() 이벤트가 다음 시도 실패로 잡히지 않도록 잠깐만 대기
+        setState(WIFI_STATE_BACKOFF);
+        return;
     }
-    Serial.println();
     
-    if (WiFi.status() == WL_CONNECTED) {
-        sysStatus.wifiConnected = true;
-        sysStatus.localIP = WiFi.localIP();
-        DebugSystem::log("✅ WiFi connected!");
-        DebugSystem::log("IP: " + WiFi.localIP().toString());
-        DebugSystem::log("RSSI: " + String(WiFi.RSSI()) + " dBm");
-        return true;
-    } else {
-        DebugSystem::log("❌ WiFi connection failed! Status: " + String(WiFi.status()));
-        sysStatus.wifiConnected = false;
-        return false;
+    failures++;
+    connectFailures.inc();
+    StatusStore::setWiFiConnected(false);
+    AppTasks::clearBits(APP_EVENT_WIFI_UP);
+    
+    // 지수 백오프 + 지터 (공유기 재부팅 후 여러 기기가 동시에 붙지 않도록)
+    unsigned long base = (unsigned long)WIFI_BACKOFF_MIN << min(failures - 1, (uint32_t)16);
+    base = min(base, (unsigned long)WIFI_BACKOFF_MAX);
+    unsigned long jitter = base * WIFI_BACKOFF_JITTER / 100;
+    backoffMs = base - jitter + esp_random() % (2 * jitter + 1);
+    
+    LOG_W(TAG, "WiFi connect failed (%s, reason %u) - retry in %lu ms", why, lastReason, backoffMs);
+    
+    // 한 번도 연결되지 않았다면 자격증명은 지우지 않고 설정용 AP를 함께 켬
+    if (!everConnected && !fallbackAP && failures >= WIFI_AP_FALLBACK_FAILURES) {
+        startAP();
+    }
+    setState(WIFI_STATE_BACKOFF);
+}
+
+// net 태스크에서 주기적으로 호출 - 기다리지 않고 현재 상태만 확인
+void WiFiManager::update() {
+    updateScan();
+    
+    switch (state) {
+        case WIFI_STATE_AP_ONLY:
+            break;
+            
+        case WIFI_STATE_CONNECTING:
+            if (disconnectEvents != seenDisconnects) {
+                onFailed("disconnected");
+            } else if (linkUp) {
+                onConnected();
+            } else if (millis() - stateSince > (attemptFast ? WIFI_FAST_JOIN_TIMEOUT : WIFI_CONNECT_TIMEOUT)) {
+                WiFi.disconnect();
+                onFailed("timeout");
+            }
+            break;
+            
+        case WIFI_STATE_CONNECTED:
+            if (disconnectEvents != seenDisconnects || !linkUp) {
+                LOG_I(TAG, "WiFi disconnected (reason %u), attempting reconnection...", lastReason);
+                StatusStore::setWiFiConnected(false);
+                AppTasks::clearBits(APP_EVENT_WIFI_UP);
+                reconnects.inc();
+                beginConnect();
+            } else if (fallbackAP && WiFi.softAPgetStationNum() == 0) {
+                // 설정 중인 사용자가 없으면 AP 종료
+                LOG_I(TAG, "Station connected - stopping fallback AP");
+                WiFi.softAPdisconnect(true);
+                WiFi.mode(WIFI_STA);
+                fallbackAP = false;
+            }
+            break;
+            
+        case WIFI_STATE_BACKOFF:
+            if (millis() - stateSince >= backoffMs) {
+                beginConnect();
+            }
+            break;
     }
 }
 
 void WiFiManager::startAP() {
-    DebugSystem::log("Starting Access Point mode");
+    // 자격증명이 있으면 스테이션 재시도를 계속하면서 AP를 함께 운영
+    fallbackAP = credentials.valid;
+    LOG_I(TAG, "Starting Access Point mode%s", fallbackAP ? " (station retries continue)" : "");
     
-    WiFi.mode(WIFI_AP);
+    WiFi.mode(fallbackAP ? WIFI_AP_STA : WIFI_AP);
     
     // MAC 주소로 고유 AP 이름 생성
     uint8_t mac[6];
@@ -84,23 +228,28 @@ void WiFiManager::startAP() {
     sprintf(apName, "%s-%02X%02X", DEFAULT_AP_SSID, mac[4], mac[5]);
     
     WiFi.softAP(apName, DEFAULT_AP_PASS);
-    sysStatus.localIP = WiFi.softAPIP();
+    if (!StatusStore::wifiConnected()) {
+        StatusStore::setLocalIP(WiFi.softAPIP());
+    }
     
-    DebugSystem::log("AP Started: " + String(apName));
-    DebugSystem::log("AP IP: " + WiFi.softAPIP().toString());
+    LOG_I(TAG, "AP Started: %s", apName);
+    LOG_I(TAG, "AP IP: %s", WiFi.softAPIP().toString().c_str());
 }
 
 void WiFiManager::loadCredentials() {
     preferences.begin("peteye", false);
     preferences.getBytes("wifi", &credentials, sizeof(credentials));
+    if (preferences.getBytes("wifi_fast", &fastJoin, sizeof(fastJoin)) != sizeof(fastJoin)) {
+        fastJoin.valid = false;
+    }
     preferences.end();
     
     if (strlen(credentials.ssid) > 0) {
         credentials.valid = true;
-        DebugSystem::log("WiFi credentials loaded from memory");
+        LOG_I(TAG, "WiFi credentials loaded from memory");
     } else {
         credentials.valid = false;
-        DebugSystem::log("No stored WiFi credentials found");
+        LOG_I(TAG, "No stored WiFi credentials found");
     }
 }
 
@@ -109,52 +258,171 @@ void WiFiManager::saveCredentials(const char* ssid, const char* password) {
     strcpy(credentials.password, password);
     credentials.valid = true;
     
+    // 다른 네트워크일 수 있으므로 빠른 접속 정보는 버림
+    memset(&fastJoin, 0, sizeof(fastJoin));
+    
     preferences.begin("peteye", false);
     preferences.putBytes("wifi", &credentials, sizeof(credentials));
+    preferences.remove("wifi_fast");
     preferences.end();
     
-    DebugSystem::log("WiFi credentials saved: " + String(ssid));
+    LOG_I(TAG, "WiFi credentials saved: %s", ssid);
 }
 
 void WiFiManager::clearCredentials() {
     memset(&credentials, 0, sizeof(credentials));
     credentials.valid = false;
+    memset(&fastJoin, 0, sizeof(fastJoin));
     
     preferences.begin("peteye", false);
     preferences.clear();
     preferences.end();
     
-    DebugSystem::log("WiFi credentials cleared");
+    LOG_I(TAG, "WiFi credentials cleared");
 }
 
 bool WiFiManager::isConnected() {
     return (WiFi.status() == WL_CONNECTED);
 }
 
-void WiFiManager::checkConnection() {
-    if (credentials.valid && !isConnected()) {
-        DebugSystem::log("WiFi disconnected, attempting reconnection...");
-        connect();
+// 연결된 AP/IP가 바뀐 경우에만 플래시에 기록
+void WiFiManager::saveFastJoin() {
+    WiFiFastJoin current;
+    memset(&current, 0, sizeof(current));
+    memcpy(current.bssid, WiFi.BSSID(), sizeof(current.bssid));
+    current.channel = WiFi.channel();
+    current.ip = WiFi.localIP();
+    current.gateway = WiFi.gatewayIP();
+    current.subnet = WiFi.subnetMask();
+    current.dns = WiFi.dnsIP();
+    current.valid = true;
+    
+    if (memcmp(&current, &fastJoin, sizeof(current)) == 0) {
+        return;
+    }
+    fastJoin = current;
+    
+    preferences.begin("peteye", false);
+    preferences.putBytes("wifi_fast", &fastJoin, sizeof(fastJoin));
+    preferences.end();
+    LOG_I(TAG, "Fast join info saved (ch %d)", fastJoin.channel);
+}
+
+const char* WiFiManager::stateName(WiFiState s) {
+    switch (s) {
+        case WIFI_STATE_AP_ONLY: return "ap";
+        case WIFI_STATE_CONNECTING: return "connecting";
+        case WIFI_STATE_CONNECTED: return "connected";
+        case WIFI_STATE_BACKOFF: return "backoff";
+        default: return "unknown";
     }
 }
 
-String WiFiManager::scanNetworks() {
-    DebugSystem::log("Starting WiFi scan");
-    int n = WiFi.scanNetworks();
-    
-    JsonDocument doc;  // ArduinoJson 7.x 문법
-    JsonArray networks = doc["networks"].to<JsonArray>();
+// 캐시가 비었거나 오래됐으면 백그라운드 스캔 요청 (웹 핸들러에서 호출)
+void WiFiManager::requestScanIfStale() {
+    if (!scanRunning && (scanTime == 0 || millis() - scanTime > WIFI_SCAN_MAX_AGE)) {
+        scanRequested = true;
+    }
+}
+
+// 비동기 스캔 시작/완료 확인 - WiFi 호출은 net 태스크에서만
+void WiFiManager::updateScan() {
+    if (scanRunning) {
+        int16_t n = WiFi.scanComplete();
+        if (n == WIFI_SCAN_RUNNING) {
+            return;
+        }
+        scanRunning = false;
+        if (n < 0) {
+            LOG_W(TAG, "WiFi scan failed");
+            return;
+        }
+        storeScan(n);
+        WiFi.scanDelete();
+        LOG_I(TAG, "WiFi scan complete: %d networks found", n);
+    } else if (scanRequested && state != WIFI_STATE_CONNECTING) {
+        // 연결 시도 중에는 채널을 옮기지 않도록 끝난 뒤 시작
+        scanRequested = false;
+        LOG_I(TAG, "Starting WiFi scan");
+        scanRunning = WiFi.scanNetworks(true) == WIFI_SCAN_RUNNING;
+    }
+}
+
+// SSID별로 가장 강한 신호만 남겨 캐시에 저장
+void WiFiManager::storeScan(int count) {
+    WiFiScanEntry results[WIFI_SCAN_MAX_RESULTS];
+    uint8_t stored = 0;
     
-    for (int i = 0; i < n; i++) {
-        JsonObject network = networks.add<JsonObject>();
-        network["ssid"] = WiFi.SSID(i);
-        network["rssi"] = WiFi.RSSI(i);
-        network["encrypted"] = (WiFi.encryptionType(i) != WIFI_AUTH_OPEN);
+    for (int i = 0; i < count; i++) {
+        String ssid = WiFi.SSID(i);
+        if (ssid.length() == 0) {
+            continue;  // 숨겨진 네트워크
+        }
+        int8_t rssi = WiFi.RSSI(i);
+        
+        int slot = -1;
+        for (int k = 0; k < stored; k++) {
+            if (strcmp(results[k].ssid, ssid.c_str()) == 0) {
+                slot = k;
+                break;
+            }
+        }
+        if (slot < 0) {
+            if (stored == WIFI_SCAN_MAX_RESULTS) {
+                continue;
+            }
+            slot = stored++;
+            strlcpy(results[slot].ssid, ssid.c_str(), sizeof(results[slot].ssid));
+        } else if (rssi <= results[slot].rssi) {
+            continue;
+        }
+        results[slot].rssi = rssi;
+        results[slot].encrypted = (WiFi.encryptionType(i) != WIFI_AUTH_OPEN);
     }
     
-    String response;
-    serializeJson(doc, response);
+    portENTER_CRITICAL(&scanMux);
+    memcpy(scanResults, results, stored * sizeof(WiFiScanEntry));
+    scanCount = stored;
+    scanTime = millis();
+    portEXIT_CRITICAL(&scanMux);
+}
+
+void WiFiManager::getScanResults(JsonObject obj) {
+    WiFiScanEntry results[WIFI_SCAN_MAX_RESULTS];
     
-    DebugSystem::log("WiFi scan complete: " + String(n) + " networks found");
-    return response;
-}
\ No newline at end of file
+    portENTER_CRITICAL(&scanMux);
+    uint8_t count = scanCount;
+    unsigned long time = scanTime;
+    memcpy(results, scanResults, count * sizeof(WiFiScanEntry));
+    portEXIT_CRITICAL(&scanMux);
+    
+    obj["scanning"] = scanRunning || scanRequested;
+    obj["ageMs"] = time != 0 ? (long)(millis() - time) : -1;
+    
+    JsonArray networks = obj["networks"].to<JsonArray>();
+    for (int i = 0; i < count; i++) {
+        JsonObject network = networks.add<JsonObject>();
+        network["ssid"] = results[i].ssid;
+        network["rssi"] = results[i].rssi;
+        network["encrypted"] = results[i].encrypted;
+    }
+}
+
+void WiFiManager::getStats(JsonObject obj) {
+    obj["state"] = stateName(state);
+    obj["ssid"] = credentials.valid ? credentials.ssid : "";
+    obj["stateMs"] = millis() - stateSince;
+    obj["attempts"] = attempts;
+    obj["failures"] = failures;
+    obj["backoffMs"] = state == WIFI_STATE_BACKOFF ? backoffMs : 0;
+    obj["lastReason"] = lastReason;
+    obj["disconnects"] = disconnectEvents;
+    obj["fallbackAP"] = fallbackAP;
+    obj["rssi"] = isConnected() ? WiFi.RSSI() : 0;
+    obj["fastJoinCached"] = fastJoin.valid;
+    obj["lastJoin"] = attemptFast ? "fast" : "scan";
+    obj["lastConnectMs"] = lastConnectMs;
+    obj["bootToConnectMs"] = bootConnectMs;
+    obj["fastJoins"] = fastJoins;
+    obj["fastJoinFallbacks"] = fastJoinFallbacks;
+}
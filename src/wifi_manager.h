@@ -4,6 +4,7 @@
 #include <WiFi.h>
 #include <Preferences.h>
 #include <ESPmDNS.h>
+#include <ArduinoJson.h>
 #include "config.h"
 #include "debug_system.h"
 
@@ -13,21 +14,85 @@ struct WiFiCredentials {
     bool valid;
 };
 
+// 마지막으로 연결에 성공한 AP와 IP 설정 - 재접속 때 스캔/DHCP를 건너뛰는 데 사용
+struct WiFiFastJoin {
+    uint8_t bssid[6];
+    int32_t channel;
+    uint32_t ip;
+    uint32_t gateway;
+    uint32_t subnet;
+    uint32_t dns;
+    bool valid;
+};
+
+// 스캔 캐시 항목
+struct WiFiScanEntry {
+    char ssid[33];
+    int8_t rssi;
+    bool encrypted;
+};
+
+// 연결 상태 - 전이는 net 태스크의 update()에서만
+enum WiFiState {
+    WIFI_STATE_AP_ONLY,      // 저장된 자격증명 없음 (설정용 AP)
+    WIFI_STATE_CONNECTING,   // WiFi.begin() 후 IP 대기
+    WIFI_STATE_CONNECTED,
+    WIFI_STATE_BACKOFF       // 실패 후 재시도 대기
+};
+
+// 이벤트 기반 연결 관리 - 어디서도 연결을 기다리며 멈추지 않음
+// WiFi 이벤트 태스크는 링크 상태만 기록하고, 재시도/백오프/AP 전환은 update()가 처리
 class WiFiManager {
 private:
     static WiFiCredentials credentials;
     static Preferences preferences;
+    static WiFiState state;
+    static unsigned long stateSince;
+    static unsigned long backoffMs;         // 이번 대기 시간
+    static uint32_t failures;               // 연속 실패 횟수
+    static uint32_t attempts;
+    static bool everConnected;              // 부팅 후 한 번이라도 연결됐는지
+    static bool fallbackAP;                 // 연결 재시도 중 설정용 AP도 켜져 있는지
+    static WiFiFastJoin fastJoin;
+    static bool tryFastJoin;                // 다음 시도를 저장된 BSSID/채널로 할지
+    static bool attemptFast;                // 현재 시도가 빠른 접속인지
+    static bool staticIP;                   // 고정 IP 설정이 적용돼 있는지
+    static uint32_t fastJoins;
+    static uint32_t fastJoinFallbacks;      // 빠른 접속 실패 후 전체 스캔으로 넘어간 횟수
+    static uint32_t lastConnectMs;          // WiFi.begin() ~ IP 획득
+    static uint32_t bootConnectMs;          // 부팅 ~ 첫 연결
+    static WiFiScanEntry scanResults[WIFI_SCAN_MAX_RESULTS];
+    static uint8_t scanCount;
+    static unsigned long scanTime;          // 마지막 스캔 완료 시각 (0 = 없음)
+    static volatile bool scanRequested;     // 웹 핸들러가 요청, update()가 시작
+    static volatile bool scanRunning;
+    static portMUX_TYPE scanMux;
+    static volatile bool linkUp;            // 이벤트 태스크가 기록
+    static volatile uint32_t disconnectEvents;
+    static volatile uint8_t lastReason;
+    static uint32_t seenDisconnects;
+    
+    static void onEvent(WiFiEvent_t event, WiFiEventInfo_t info);
+    static void beginConnect();
+    static void onConnected();
+    static void onFailed(const char* why);
+    static void setState(WiFiState next);
+    static void saveFastJoin();
+    static void updateScan();
+    static void storeScan(int count);
     
 public:
     static void init();
-    static bool connect();
+    static void update();
     static void startAP();
     static void loadCredentials();
     static void saveCredentials(const char* ssid, const char* password);
     static void clearCredentials();
     static bool isConnected();
-    static void checkConnection();
-    static String scanNetworks();
+    static const char* stateName(WiFiState s);
+    static void requestScanIfStale();
+    static void getScanResults(JsonObject obj);
+    static void getStats(JsonObject obj);
 };
 
-#endif // WIFI_MANAGER_H
\ No newline at end of file
+#endif // WIFI_MANAGER_H
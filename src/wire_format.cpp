@@ -0,0 +1,74 @@
+#include "wire_format.h"
+#include "debug_system.h"
+
+static constexpr char TAG[] = "wire";
+
+#define MSGPACK_CONTENT_TYPE "application/msgpack"
+
+WireFormat WireCodec::uploadFormatSetting = UPLOAD_WIRE_MSGPACK ? WIRE_MSGPACK : WIRE_JSON;
+bool WireCodec::msgPackRejected = false;
+
+WireFormat WireCodec::uploadFormat() {
+    return msgPackRejected ? WIRE_JSON : uploadFormatSetting;
+}
+
+void WireCodec::setUploadFormat(WireFormat format) {
+    uploadFormatSetting = format;
+    msgPackRejected = false;  // 명시적으로 다시 선택하면 협상을 새로 시작
+    LOG_I(TAG, "Upload wire format: %s", name(format));
+}
+
+void WireCodec::markMsgPackRejected() {
+    if (!msgPackRejected) {
+        msgPackRejected = true;
+        LOG_W(TAG, "⚠️ Backend rejected MessagePack (415) - falling back to JSON");
+    }
+}
+
+bool WireCodec::isMsgPackRejected() {
+    return msgPackRejected;
+}
+
+size_t WireCodec::measure(const JsonDocument& doc, WireFormat format) {
+    return format == WIRE_MSGPACK ? measureMsgPack(doc) : measureJson(doc);
+}
+
+size_t WireCodec::encode(const JsonDocument& doc, WireFormat format, uint8_t* buf, size_t capacity) {
+    // 크기는 호출자가 이미 잼 (measure() + 1) - 직렬화를 한 번만 하고 버퍼를 다 채웠으면 잘린 것으로 봄
+    size_t len = format == WIRE_MSGPACK ? serializeMsgPack(doc, buf, capacity)
+                                        : serializeJson(doc, (char*)buf, capacity);
+    return len < capacity ? len : 0;
+}
+
+size_t WireCodec::write(const JsonDocument& doc, WireFormat format, Print& out) {
+    return format == WIRE_MSGPACK ? serializeMsgPack(doc, out) : serializeJson(doc, out);
+}
+
+bool WireCodec::decode(const uint8_t* data, size_t len, WireFormat format, JsonDocument& doc) {
+    DeserializationError error = format == WIRE_MSGPACK ? deserializeMsgPack(doc, data, len)
+                                                        : deserializeJson(doc, (const char*)data, len);
+    return !error;
+}
+
+const char* WireCodec::contentType(WireFormat format) {
+    return format == WIRE_MSGPACK ? MSGPACK_CONTENT_TYPE : "application/json";
+}
+
+const char* WireCodec::name(WireFormat format) {
+    return format == WIRE_MSGPACK ? "msgpack" : "json";
+}
+
+bool WireCodec::parse(const String& name, WireFormat& format) {
+    if (name == "json") {
+        format = WIRE_JSON;
+    } else if (name == "msgpack") {
+        format = WIRE_MSGPACK;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+WireFormat WireCodec::fromAccept(const String& accept) {
+    return accept.indexOf(MSGPACK_CONTENT_TYPE) >= 0 ? WIRE_MSGPACK : WIRE_JSON;
+}
@@ -0,0 +1,37 @@
+#ifndef WIRE_FORMAT_H
+#define WIRE_FORMAT_H
+
+#include <ArduinoJson.h>
+#include "config.h"
+
+enum WireFormat {
+    WIRE_JSON,
+    WIRE_MSGPACK
+};
+
+// JSON / MessagePack 인코딩 선택
+// - 업로드: 설정값으로 시작, 백엔드가 415를 돌려주면 JSON으로 자동 전환
+// - 기기 API 응답: 요청의 Accept 헤더로 결정
+// 인코딩은 호출자가 미리 잡아둔 버퍼나 응답 스트림에 직접 씀 (중간 String 없음)
+class WireCodec {
+private:
+    static WireFormat uploadFormatSetting;
+    static bool msgPackRejected;
+
+public:
+    static WireFormat uploadFormat();
+    static void setUploadFormat(WireFormat format);
+    static void markMsgPackRejected();
+    static bool isMsgPackRejected();
+
+    static size_t measure(const JsonDocument& doc, WireFormat format);
+    static size_t encode(const JsonDocument& doc, WireFormat format, uint8_t* buf, size_t capacity);  // 0 = 버퍼 부족
+    static size_t write(const JsonDocument& doc, WireFormat format, Print& out);
+    static bool decode(const uint8_t* data, size_t len, WireFormat format, JsonDocument& doc);
+    static const char* contentType(WireFormat format);
+    static const char* name(WireFormat format);
+    static bool parse(const String& name, WireFormat& format);
+    static WireFormat fromAccept(const String& accept);
+};
+
+#endif // WIRE_FORMAT_H
@@ -0,0 +1,67 @@
+# PlatformIO pre 스크립트: src/web_pages.h 의 정적 페이지를 gzip 해 src/web_pages_gz.h 로 생성
+# 단독 실행도 가능:  python tools/gzip_pages.py
+import gzip
+import hashlib
+import os
+import re
+
+# 값이 서버에서 채워지지 않는 정적 페이지만 (템플릿 페이지는 런타임 렌더링)
+STATIC_PAGES = ("INDEX_HTML", "DEBUG_HTML")
+
+PAGE_RE = re.compile(r'const char (\w+)\[\] PROGMEM = R"rawliteral\((.*?)\)rawliteral";', re.S)
+
+
+def render(pages):
+    out = [
+        "// 자동 생성 파일 - tools/gzip_pages.py 가 web_pages.h 에서 만듦. 직접 수정하지 말 것",
+        "#ifndef WEB_PAGES_GZ_H",
+        "#define WEB_PAGES_GZ_H",
+        "",
+        "#include <Arduino.h>",
+        "",
+    ]
+    for name, text in pages:
+        data = text.encode("utf-8")
+        blob = gzip.compress(data, 9, mtime=0)  # mtime 고정 - 같은 입력이면 같은 바이트
+        etag = hashlib.sha256(blob).hexdigest()[:16]  # gzip 바이트 기준 강한 ETag
+        out.append("// %s: %d -> %d bytes" % (name, len(data), len(blob)))
+        out.append('#define %s_ETAG "\\"%s\\""' % (name, etag))
+        out.append("const size_t %s_GZ_LEN = %d;" % (name, len(blob)))
+        out.append("const uint8_t %s_GZ[] PROGMEM = {" % name)
+        for i in range(0, len(blob), 16):
+            out.append("    " + ", ".join("0x%02x" % b for b in blob[i:i + 16]) + ",")
+        out.append("};")
+        out.append("")
+    out.append("#endif // WEB_PAGES_GZ_H")
+    return "\n".join(out) + "\n"
+
+
+def generate(project_dir):
+    src = os.path.join(project_dir, "src", "web_pages.h")
+    dst = os.path.join(project_dir, "src", "web_pages_gz.h")
+
+    with open(src, encoding="utf-8") as f:
+        found = dict(PAGE_RE.findall(f.read()))
+
+    missing = [name for name in STATIC_PAGES if name not in found]
+    if missing:
+        raise SystemExit("gzip_pages: %s not found in web_pages.h" % ", ".join(missing))
+
+    content = render([(name, found[name]) for name in STATIC_PAGES])
+
+    # 내용이 같으면 건드리지 않음 (불필요한 재컴파일 방지)
+    if os.path.exists(dst):
+        with open(dst, encoding="utf-8") as f:
+            if f.read() == content:
+                return
+    with open(dst, "w", encoding="utf-8", newline="\n") as f:
+        f.write(content)
+    print("gzip_pages: wrote " + dst)
+
+
+try:
+    Import("env")  # noqa: F821 - PlatformIO(SCons)에서 실행될 때
+    generate(env["PROJECT_DIR"])  # noqa: F821
+except NameError:
+    if __name__ == "__main__":
+        generate(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
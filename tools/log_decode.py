@@ -0,0 +1,95 @@
+# 바이너리 로그 해석기 - /api/log/raw 응답이나 시리얼 캡처를 텍스트로 바꿈
+#   curl -s http://peteye.local/api/log/raw | python tools/log_decode.py -t .pio/build/t-cameras3/log_strings.json
+#   python tools/log_decode.py -t log_strings.json serial_capture.bin
+# 프레임: A5 5A <길이> <포맷 ID u32><시각 ms u32><레벨 u8><인자...> (리틀 엔디언)
+import argparse
+import json
+import re
+import struct
+import sys
+
+SYNC = b"\xa5\x5a"
+LEVELS = "-EWIDT"
+SPEC_RE = re.compile(r"%([-+ #0]*\d*(?:\.\d+)?)(hh|h|ll|l|z|j|t)?([diouxXcsfFeEgGp%])")
+
+
+def render(fmt, payload):
+    pos = 0
+    out = []
+    last = 0
+    for m in SPEC_RE.finditer(fmt):
+        out.append(fmt[last:m.start()])
+        last = m.end()
+        flags, length, conv = m.groups()
+        if conv == "%":
+            out.append("%")
+            continue
+        if conv == "s":
+            n = payload[pos]
+            value = payload[pos + 1:pos + 1 + n].decode("utf-8", "replace")
+            pos += 1 + n
+        elif conv in "fFeEgG":
+            value = struct.unpack_from("<f", payload, pos)[0]
+            pos += 4
+        elif length == "ll":
+            value = struct.unpack_from("<q" if conv in "di" else "<Q", payload, pos)[0]
+            pos += 8
+        else:
+            value = struct.unpack_from("<i" if conv in "di" else "<I", payload, pos)[0]
+            pos += 4
+        if conv == "c":
+            value = chr(value & 0xFF)
+        elif conv == "u":
+            conv = "d"
+        elif conv == "p":
+            conv = "x"
+        out.append(("%" + flags + conv) % value)
+    out.append(fmt[last:])
+    return "".join(out)
+
+
+def frames(data):
+    i = 0
+    while True:
+        i = data.find(SYNC, i)
+        if i < 0 or i + 3 > len(data):
+            return
+        n = data[i + 2]
+        record = data[i + 3:i + 3 + n]
+        if n < 9 or len(record) < n:
+            i += 1  # 텍스트 출력 사이에 섞인 가짜 동기 바이트
+            continue
+        yield record
+        i += 3 + n
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode PetEye binary logs")
+    parser.add_argument("-t", "--table", required=True, help="log_strings.json from the build")
+    parser.add_argument("input", nargs="?", help="raw log file (default: stdin)")
+    args = parser.parse_args()
+
+    with open(args.table, encoding="utf-8") as f:
+        table = json.load(f)
+    if args.input:
+        with open(args.input, "rb") as f:
+            data = f.read()
+    else:
+        data = sys.stdin.buffer.read()
+
+    for record in frames(data):
+        format_id, ms, level = struct.unpack_from("<IIB", record)
+        entry = table.get("%08x" % format_id)
+        prefix = "%d.%03ds %s" % (ms // 1000, ms % 1000, LEVELS[min(level, 5)])
+        if entry is None:
+            print("%s #%08x (unknown format, %d bytes)" % (prefix, format_id, len(record) - 9))
+            continue
+        try:
+            text = render(entry["format"], record[9:])
+        except (struct.error, IndexError, TypeError, ValueError):
+            text = entry["format"] + " <bad arguments>"
+        print("%s %s: %s" % (prefix, entry["tag"], text))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,74 @@
+# PlatformIO pre 스크립트: src 의 LOG_E/W/I/D/T 문장에서 포맷 문자열 표를 만듦 (바이너리 로그 해석용)
+# 빌드 시 $BUILD_DIR/log_strings.json 에 기록, 단독 실행:  python tools/log_strings.py [출력 경로]
+import glob
+import json
+import os
+import re
+import sys
+
+TAG_RE = re.compile(r'static constexpr char TAG\[\] = "([^"]*)";')
+LOG_RE = re.compile(r'\bLOG_([EWIDT])\(\s*TAG\s*,\s*"((?:[^"\\]|\\.)*)"')
+ISR_RE = re.compile(r'\blogFromISR\(\s*LOG_LEVEL_(\w+)\s*,\s*TAG\s*,\s*"((?:[^"\\]|\\.)*)"')
+
+ESCAPES = {"n": "\n", "t": "\t", "r": "\r", '"': '"', "\\": "\\", "0": "\0"}
+
+
+def unescape(literal):
+    return re.sub(r'\\(.)', lambda m: ESCAPES.get(m.group(1), m.group(1)), literal)
+
+
+# DebugSystem::formatId() 와 같은 계산 - FNV-1a("tag:format")
+def format_id(tag, fmt):
+    h = 2166136261
+    for b in (tag + ":" + fmt).encode("utf-8"):
+        h = ((h ^ b) * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def collect(project_dir):
+    table = {}
+    for path in sorted(glob.glob(os.path.join(project_dir, "src", "*.cpp"))):
+        with open(path, encoding="utf-8") as f:
+            text = f.read()
+        tag = TAG_RE.search(text)
+        if tag is None:
+            continue
+        tag = tag.group(1)
+
+        for regex in (LOG_RE, ISR_RE):
+            for m in regex.finditer(text):
+                fmt = unescape(m.group(2))
+                key = "%08x" % format_id(tag, fmt)
+                entry = {
+                    "level": m.group(1)[0],
+                    "tag": tag,
+                    "format": fmt,
+                    "file": os.path.basename(path),
+                    "line": text.count("\n", 0, m.start()) + 1,
+                }
+                old = table.get(key)
+                if old is not None and (old["tag"], old["format"]) != (tag, fmt):
+                    raise SystemExit("log_strings: format id collision %s: %r vs %r" % (key, old, entry))
+                table.setdefault(key, entry)
+    return table
+
+
+def generate(project_dir, out_path):
+    content = json.dumps(collect(project_dir), indent=1, ensure_ascii=False, sort_keys=True) + "\n"
+    if os.path.exists(out_path):
+        with open(out_path, encoding="utf-8") as f:
+            if f.read() == content:
+                return
+    os.makedirs(os.path.dirname(out_path) or ".", exist_ok=True)
+    with open(out_path, "w", encoding="utf-8", newline="\n") as f:
+        f.write(content)
+    print("log_strings: wrote " + out_path)
+
+
+try:
+    Import("env")  # noqa: F821 - PlatformIO(SCons)에서 실행될 때
+    generate(env["PROJECT_DIR"], os.path.join(env.subst("$BUILD_DIR"), "log_strings.json"))  # noqa: F821
+except NameError:
+    if __name__ == "__main__":
+        root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+        generate(root, sys.argv[1] if len(sys.argv) > 1 else "log_strings.json")
@@ -0,0 +1,68 @@
+// StatusStore seqlock 호스트 스트레스 테스트
+// 쓰기 스레드 하나가 setTemperature(temp, readAt)를 계속 호출하고 (temp는 readAt에서 계산)
+// 읽기 스레드 N개가 read() 스냅샷마다 두 값이 서로 맞는지, readAt이 뒤로 가지 않는지 확인
+//   g++ -std=gnu++11 -O2 -pthread -Itools/stress_stub -Isrc tools/status_store_stress.cpp src/status_store.cpp -o /tmp/status_store_stress
+//   /tmp/status_store_stress [읽기 스레드 수=4] [쓰기 횟수=5000000]
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "status_store.h"
+
+// float로 정확히 표현되는 값만 (비교가 반올림에 흔들리지 않도록)
+static float tempFor(unsigned long readAt) {
+    return (float)(readAt % 100000) / 4.0f;
+}
+
+static std::atomic<bool> writing(true);
+static std::atomic<uint64_t> totalReads(0);
+static std::atomic<uint64_t> torn(0);
+static std::atomic<uint64_t> backwards(0);
+
+static void writer(unsigned long writes) {
+    for (unsigned long readAt = 1; readAt <= writes; readAt++) {
+        StatusStore::setTemperature(tempFor(readAt), readAt);
+    }
+    writing = false;
+}
+
+static void reader() {
+    uint64_t reads = 0;
+    unsigned long last = 0;
+    SystemStatus status;
+    while (writing) {
+        StatusStore::read(status);
+        reads++;
+        if (status.currentTemp != tempFor(status.lastTempRead)) {
+            if (torn++ == 0) {
+                fprintf(stderr, "torn snapshot: readAt=%lu temp=%.2f\n", status.lastTempRead, status.currentTemp);
+            }
+        }
+        if (status.lastTempRead < last) {
+            backwards++;
+        }
+        last = status.lastTempRead;
+    }
+    totalReads += reads;
+}
+
+int main(int argc, char** argv) {
+    int readers = argc > 1 ? atoi(argv[1]) : 4;
+    unsigned long writes = argc > 2 ? strtoul(argv[2], nullptr, 10) : 5000000;
+
+    StatusStore::setTemperature(tempFor(0), 0);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < readers; i++) {
+        threads.emplace_back(reader);
+    }
+    std::thread w(writer, writes);
+    w.join();
+    for (std::thread& t : threads) {
+        t.join();
+    }
+
+    printf("%d readers, %lu writes, %llu reads, %llu torn, %llu backwards\n", readers, writes,
+           (unsigned long long)totalReads, (unsigned long long)torn, (unsigned long long)backwards);
+    return torn == 0 && backwards == 0 ? 0 : 1;
+}
@@ -0,0 +1,44 @@
+// 호스트 빌드용 최소 Arduino/FreeRTOS 대체 헤더 - tools/status_store_stress.cpp 전용
+// StatusStore가 쓰는 것만 (String, IPAddress, portMUX 임계 구역)
+#ifndef STRESS_STUB_ARDUINO_H
+#define STRESS_STUB_ARDUINO_H
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+class String : public std::string {
+public:
+    String() {}
+    String(const char* s) : std::string(s) {}
+};
+
+class IPAddress {
+public:
+    IPAddress(uint32_t value = 0) : address(value) {}
+    operator uint32_t() const { return address; }
+private:
+    uint32_t address;
+};
+
+template <typename T>
+inline T min(T a, T b) { return a < b ? a : b; }
+
+// ESP32의 portMUX는 코어 간 스핀락 - 호스트에서는 스레드 간 스핀락으로
+struct portMUX_TYPE {
+    std::atomic_flag flag;
+};
+#define portMUX_INITIALIZER_UNLOCKED {ATOMIC_FLAG_INIT}
+
+inline void portENTER_CRITICAL(portMUX_TYPE* mux) {
+    while (mux->flag.test_and_set(std::memory_order_acquire)) {
+    }
+}
+
+inline void portEXIT_CRITICAL(portMUX_TYPE* mux) {
+    mux->flag.clear(std::memory_order_release);
+}
+
+#endif // STRESS_STUB_ARDUINO_H
@@ -0,0 +1,103 @@
+// JSON / MessagePack 호스트 벤치마크 - 텔레메트리 배치와 같은 모양의 문서로 크기와 인코딩/디코딩 시간 비교
+// 인코딩은 WireCodec::encode와 같은 방식 (measure() + 1 버퍼에 한 번 직렬화), 기기 측정은 /api/test/wire
+// ArduinoJson은 PlatformIO가 받은 것을 그대로 사용 (pio pkg install 후):
+//   g++ -std=gnu++11 -O2 -I.pio/libdeps/t-cameras3/ArduinoJson/src tools/wire_bench.cpp -o /tmp/wire_bench
+//   /tmp/wire_bench [반복 횟수=2000]
+#include <ArduinoJson.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#define TELEMETRY_BATCH_SIZE 30   // src/config.h 와 같게
+
+enum Format { FORMAT_JSON, FORMAT_MSGPACK };
+
+static const char* const FORMAT_NAMES[] = {"json", "msgpack"};
+
+// TelemetryBatcher::buildDocument 와 같은 필드/구조
+static void buildBatch(JsonDocument& doc, int readings, int probes) {
+    doc["device_id"] = "PETEYE_A1B2C3D4E5F6";
+
+    JsonArray probeIds = doc["probe_ids"].to<JsonArray>();
+    for (int i = 0; i < probes; i++) {
+        char address[17];
+        snprintf(address, sizeof(address), "28FF64%02X1E0A3C%02X", i, 0x40 + i);
+        probeIds.add(address);
+    }
+
+    JsonArray items = doc["readings"].to<JsonArray>();
+    for (int n = 0; n < readings; n++) {
+        JsonObject item = items.add<JsonObject>();
+        item["timestamp"] = 3600 + n * 10;
+        item["temperature"] = 24.5f + (n % 7) * 0.0625f;
+        item["rssi"] = -58 - (n % 5);
+        item["free_heap"] = 183000 - n * 16;
+
+        JsonArray values = item["probes"].to<JsonArray>();
+        for (int i = 0; i < probes; i++) {
+            values.add(24.5f + i * 0.25f + (n % 3) * 0.0625f);
+        }
+    }
+}
+
+static size_t measure(const JsonDocument& doc, Format format) {
+    return format == FORMAT_MSGPACK ? measureMsgPack(doc) : measureJson(doc);
+}
+
+static size_t encode(const JsonDocument& doc, Format format, uint8_t* buf, size_t capacity) {
+    size_t len = format == FORMAT_MSGPACK ? serializeMsgPack(doc, buf, capacity)
+                                          : serializeJson(doc, (char*)buf, capacity);
+    return len < capacity ? len : 0;
+}
+
+static double elapsedUs(std::chrono::steady_clock::time_point start, int iterations) {
+    std::chrono::duration<double, std::micro> total = std::chrono::steady_clock::now() - start;
+    return total.count() / iterations;
+}
+
+int main(int argc, char** argv) {
+    int iterations = argc > 1 ? atoi(argv[1]) : 2000;
+    const int readingCounts[] = {1, 10, TELEMETRY_BATCH_SIZE - 1};
+    const int probeCounts[] = {1, 4};
+
+    printf("%-9s %-7s %-8s %8s %10s %10s\n", "readings", "probes", "format", "bytes", "encode us", "decode us");
+    for (int readings : readingCounts) {
+        for (int probes : probeCounts) {
+            JsonDocument doc;
+            buildBatch(doc, readings, probes);
+
+            for (int f = FORMAT_JSON; f <= FORMAT_MSGPACK; f++) {
+                Format format = (Format)f;
+                std::vector<uint8_t> buffer(measure(doc, format) + 1);
+
+                size_t len = 0;
+                std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                for (int i = 0; i < iterations; i++) {
+                    len = encode(doc, format, buffer.data(), buffer.size());
+                }
+                double encodeUs = elapsedUs(start, iterations);
+                if (len == 0) {
+                    fprintf(stderr, "encode failed: %d readings, %d probes, %s\n", readings, probes, FORMAT_NAMES[f]);
+                    return 1;
+                }
+
+                JsonDocument decoded;
+                start = std::chrono::steady_clock::now();
+                for (int i = 0; i < iterations; i++) {
+                    DeserializationError error = format == FORMAT_MSGPACK
+                        ? deserializeMsgPack(decoded, buffer.data(), len)
+                        : deserializeJson(decoded, (const char*)buffer.data(), len);
+                    if (error) {
+                        fprintf(stderr, "decode failed: %s\n", error.c_str());
+                        return 1;
+                    }
+                }
+                double decodeUs = elapsedUs(start, iterations);
+
+                printf("%-9d %-7d %-8s %8zu %10.2f %10.2f\n", readings, probes, FORMAT_NAMES[f], len, encodeUs, decodeUs);
+            }
+        }
+    }
+    return 0;
+}